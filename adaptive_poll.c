@@ -0,0 +1,152 @@
+#include <stddef.h>
+#include "adaptive_poll.h"
+#include "event_monitor.h"
+#include "rtos_api.h"
+
+static uint32_t enter_threshold = 0;
+static uint32_t exit_idle = 0;
+static uint32_t poll_period_ms = 0;
+static adaptive_report_t report_sink = NULL;
+
+// Shared between the callback and the timer task under the lock
+static volatile adaptive_mode_t mode = ADAPTIVE_MODE_INTERRUPT;
+static uint32_t changes = 0;          // Changes seen since the last tick
+static uint32_t idle_polls = 0;
+static uint32_t mode_since = 0;       // Timestamp of the last switch or window
+static uint32_t mode_ticks[2];
+static uint32_t window_switches = 0;
+
+static void adaptive_poll_on_change(const event_change_t* change);
+static void adaptive_poll_on_window(void);
+
+static const event_observer_t adaptive_observer = {
+    adaptive_poll_on_change,
+    adaptive_poll_on_window,
+    NULL
+};
+
+static void adaptive_poll_on_change(const event_change_t* change) {
+    // Polled samples reach the observers whether or not anything changed
+    if (change->previous_state != change->new_state) {
+        rtos_mutex_lock();
+        ++changes;
+        rtos_mutex_unlock();
+    }
+}
+
+// Credits the time since the last switch to the current mode; called under the lock
+static void account_time(uint32_t now) {
+    mode_ticks[mode] += now - mode_since;
+    mode_since = now;
+}
+
+static void switch_mode(adaptive_mode_t next) {
+    rtos_mutex_lock();
+    account_time(gpio_read_timestamp());
+    mode = next;
+    changes = 0;
+    idle_polls = 0;
+    ++window_switches;
+    rtos_mutex_unlock();
+
+    event_monitor_mask_interrupts(next == ADAPTIVE_MODE_POLLING ? 0xFFFFFFFFu : 0);
+    // Pick up whatever changed around the switch; the shared previous state
+    // keeps edges the callback already counted from being counted again
+    event_monitor_sample(gpio_read_input());
+}
+
+void adaptive_poll_tick(void) {
+    uint32_t seen;
+    uint32_t idle;
+
+    if (mode == ADAPTIVE_MODE_INTERRUPT) {
+        rtos_mutex_lock();
+        seen = changes;
+        changes = 0;
+        rtos_mutex_unlock();
+
+        if (seen > enter_threshold) {
+            switch_mode(ADAPTIVE_MODE_POLLING);
+        }
+        return;
+    }
+
+    event_monitor_sample(gpio_read_input());
+
+    rtos_mutex_lock();
+    idle_polls = changes ? 0 : idle_polls + 1;
+    changes = 0;
+    idle = idle_polls;
+    rtos_mutex_unlock();
+
+    if (idle >= exit_idle) {
+        switch_mode(ADAPTIVE_MODE_INTERRUPT);
+    }
+}
+
+adaptive_mode_t adaptive_poll_mode(void) {
+    return mode;
+}
+
+static void adaptive_poll_on_window(void) {
+    uint32_t ticks[2];
+    uint32_t switches;
+
+    rtos_mutex_lock();
+    account_time(gpio_read_timestamp());
+    ticks[ADAPTIVE_MODE_INTERRUPT] = mode_ticks[ADAPTIVE_MODE_INTERRUPT];
+    ticks[ADAPTIVE_MODE_POLLING] = mode_ticks[ADAPTIVE_MODE_POLLING];
+    switches = window_switches;
+    mode_ticks[ADAPTIVE_MODE_INTERRUPT] = 0;
+    mode_ticks[ADAPTIVE_MODE_POLLING] = 0;
+    window_switches = 0;
+    rtos_mutex_unlock();
+
+    if (report_sink) {
+        report_sink(ticks[ADAPTIVE_MODE_INTERRUPT], ticks[ADAPTIVE_MODE_POLLING], switches);
+    }
+}
+
+static void timer_task(void* arg) {
+    (void)arg; // Suppress unused parameter warning
+
+    while (1) {
+        rtos_task_delay_ms(poll_period_ms);
+
+        adaptive_poll_tick();
+    }
+}
+
+int adaptive_poll_init(uint32_t enter_changes, uint32_t exit_idle_polls, uint32_t poll_ms, adaptive_report_t sink) {
+    static rtos_task_t task;
+    static int task_created = 0;
+
+    if (exit_idle_polls == 0 || poll_ms == 0) {
+        return -1;
+    }
+
+    event_monitor_remove_observer(&adaptive_observer);
+
+    rtos_mutex_lock();
+    enter_threshold = enter_changes;
+    exit_idle = exit_idle_polls;
+    poll_period_ms = poll_ms;
+    report_sink = sink;
+    mode = ADAPTIVE_MODE_INTERRUPT;
+    changes = 0;
+    idle_polls = 0;
+    mode_since = gpio_read_timestamp();
+    mode_ticks[ADAPTIVE_MODE_INTERRUPT] = 0;
+    mode_ticks[ADAPTIVE_MODE_POLLING] = 0;
+    window_switches = 0;
+    rtos_mutex_unlock();
+
+    event_monitor_mask_interrupts(0);
+
+    if (!task_created) {
+        rtos_task_create(&task, timer_task, NULL);
+        task_created = 1;
+    }
+
+    return event_monitor_add_observer(&adaptive_observer);
+}
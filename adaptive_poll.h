@@ -0,0 +1,41 @@
+#ifndef ADAPTIVE_POLL_H
+#define ADAPTIVE_POLL_H
+
+#include <stdint.h>
+#include "gpio_hal.h"
+
+// Switches the monitor between interrupt-driven callbacks and polling the
+// port from a timer task, as NAPI does for network drivers. When more than
+// enter_changes callbacks arrive within one poll period, all change
+// interrupts are masked and the task samples gpio_read_input() every poll
+// period instead; after exit_idle_polls samples in a row without a change,
+// interrupts are enabled again. Both modes count through the shared previous
+// state, and the port is sampled right after each switch, so no edge is lost
+// or counted twice across a transition. While polling, pulses shorter than
+// the poll period are not seen.
+//
+// Masks all pins while polling; do not combine with the storm guard.
+
+typedef enum {
+    ADAPTIVE_MODE_INTERRUPT,
+    ADAPTIVE_MODE_POLLING
+} adaptive_mode_t;
+
+// Receives the gpio_read_timestamp() ticks spent in each mode over the last
+// report window and the number of mode switches during it
+typedef void (*adaptive_report_t)(uint32_t interrupt_ticks, uint32_t polling_ticks, uint32_t switches);
+
+// Hooks the switcher into the monitor and creates its timer task, starting in
+// interrupt mode. The sink is called after each report_event_count(). Returns
+// 0 on success, -1 on invalid parameters or a full observer table.
+int adaptive_poll_init(uint32_t enter_changes, uint32_t exit_idle_polls, uint32_t poll_ms, adaptive_report_t sink);
+
+// One timer step: measures the interrupt rate, or samples the port while
+// polling, and switches modes. The timer task calls this every poll_ms; hosts
+// that drive time themselves (tests) may call it directly.
+void adaptive_poll_tick(void);
+
+// Returns the current mode
+adaptive_mode_t adaptive_poll_mode(void);
+
+#endif // ADAPTIVE_POLL_H
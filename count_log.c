@@ -0,0 +1,159 @@
+#include <stddef.h>
+#include <string.h>
+#include "count_log.h"
+#include "event_monitor.h"
+#include "pin_bits.h"
+#include "rtos_api.h"
+
+static uint8_t log_data[COUNT_LOG_SIZE];
+static volatile uint32_t log_len = 0;
+static volatile uint32_t dropped = 0;
+static uint8_t full = 0;
+
+static gpio_mask_t logged_pins = 0;
+static unsigned pin_count = 0;
+
+// State after the last logged record, the base for the next one
+static uint32_t last_timestamp = 0;
+static uint32_t last_delta = 0;
+static uint32_t last_counts[32];
+static uint32_t generation = 0;  // Bumped by every reset
+
+
+static void put_u32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static uint8_t* put_varint(uint8_t* p, uint32_t v) {
+    while (v >= 0x80) {
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+// Maps a difference taken modulo 2^32 to small unsigned values
+static uint32_t zigzag(uint32_t v) {
+    return (v << 1) ^ (0u - (v >> 31));
+}
+
+// Encodes one record against the last logged state
+static uint32_t encode(uint8_t* record, uint32_t timestamp, const uint32_t* window_counts) {
+    uint8_t* p = record;
+    uint32_t run = 0;
+    unsigned i;
+
+    p = put_varint(p, zigzag(timestamp - last_timestamp - last_delta));
+    for (i = 0; i < pin_count; ++i) {
+        uint32_t value = zigzag(window_counts[i] - last_counts[i]);
+        if (value == 0) {
+            ++run;
+            continue;
+        }
+        p = put_varint(p, run);
+        p = put_varint(p, value);
+        run = 0;
+    }
+    if (run) {
+        p = put_varint(p, run);
+    }
+    return (uint32_t)(p - record);
+}
+
+// Logs the window of the monitor's report, which carries its per-pin counts
+static void count_log_report(const event_report_t* report) {
+    uint8_t record[COUNT_LOG_MAX_RECORD_SIZE];
+    uint32_t window_counts[32];
+    uint32_t timestamp = report->end_timestamp;
+    uint32_t record_len;
+    uint32_t log_generation;
+    unsigned i;
+
+    pin_bits_gather(window_counts, report->pin_counts, logged_pins);
+    event_monitor_release_report(report);
+
+    rtos_mutex_lock();
+    log_generation = generation;
+    rtos_mutex_unlock();
+
+    while (1) {
+        record_len = encode(record, timestamp, window_counts);
+
+        rtos_mutex_lock();
+        if (generation != log_generation) {
+            // Reset while encoding: encode again against the fresh log
+            log_generation = generation;
+            rtos_mutex_unlock();
+            continue;
+        }
+        if (full || log_len + record_len > COUNT_LOG_SIZE) {
+            // Full until reset, so the logged windows stay consecutive
+            full = 1;
+            ++dropped;
+        } else {
+            memcpy(log_data + log_len, record, record_len);
+            log_len += record_len;
+            last_delta = timestamp - last_timestamp;
+            last_timestamp = timestamp;
+            for (i = 0; i < pin_count; ++i) {
+                last_counts[i] = window_counts[i];
+            }
+        }
+        rtos_mutex_unlock();
+        break;
+    }
+}
+
+const uint8_t* count_log_data(uint32_t* len) {
+    *len = log_len;
+    return log_data;
+}
+
+// Writes the header and clears the delta state; called under the lock
+static void start_log(void) {
+    unsigned i;
+
+    memcpy(log_data, COUNT_LOG_MAGIC, 4);
+    log_data[4] = COUNT_LOG_VERSION;
+    log_data[5] = 0;
+    log_data[6] = 0;
+    log_data[7] = 0;
+    put_u32(log_data + 8, logged_pins);
+    log_len = COUNT_LOG_HEADER_SIZE;
+    full = 0;
+    ++generation;
+
+    last_timestamp = 0;
+    last_delta = 0;
+    for (i = 0; i < 32; ++i) {
+        last_counts[i] = 0;
+    }
+}
+
+void count_log_reset(void) {
+    rtos_mutex_lock();
+    start_log();
+    rtos_mutex_unlock();
+}
+
+uint32_t count_log_dropped(void) {
+    return dropped;
+}
+
+int count_log_init(gpio_mask_t pins) {
+    event_monitor_remove_report_sink(count_log_report);
+
+    rtos_mutex_lock();
+    logged_pins = pins;
+    pin_count = pin_bits_count(pins);
+    dropped = 0;
+    start_log();
+    rtos_mutex_unlock();
+
+    event_monitor_count_pins(1);
+    return event_monitor_add_report_sink(count_log_report);
+}
@@ -0,0 +1,56 @@
+#ifndef COUNT_LOG_H
+#define COUNT_LOG_H
+
+#include <stdint.h>
+#include "gpio_hal.h"
+
+// Compressed log of per-pin window counts (all integers little-endian):
+//
+//   Header (COUNT_LOG_HEADER_SIZE bytes)
+//     char[4]  magic "CLOG"
+//     uint8    version
+//     uint8[3] reserved, zero
+//     uint32   logged pin mask
+//
+//   One record per report window
+//     varint   zigzag(delta-of-delta of the window timestamp)
+//     then, over the logged pins in pin order, zigzag(count - previous
+//     count) with runs of zeros collapsed: varint(zero run length), and
+//     unless the run reaches the last pin, varint(non-zero value)
+//
+// Timestamps are the end_timestamp of each window's report; their
+// deltas are taken modulo 2^32. Before the first record the timestamp,
+// timestamp delta and counts are all zero. A steady report period and
+// unchanged counts cost two bytes per window.
+
+#define COUNT_LOG_MAGIC "CLOG"
+#define COUNT_LOG_VERSION 1
+#define COUNT_LOG_HEADER_SIZE 12
+
+// Worst-case record size: 5-byte timestamp, then a run and a value per pin
+#define COUNT_LOG_MAX_RECORD_SIZE (5 + 32 * 6)
+
+// Size of the static log, header included
+#ifndef COUNT_LOG_SIZE
+#define COUNT_LOG_SIZE 4096
+#endif
+
+// Starts logging the rising edges on pins (monitored pins only are seen)
+// every report window, replacing any log kept so far. The counts come from
+// the monitor's report; this enables its per-pin counting.
+// Returns 0 on success, -1 if the report sink table is full.
+int count_log_init(gpio_mask_t pins);
+
+// Returns the log and sets *len to its size. The bytes stay valid, and
+// only grow, until count_log_reset().
+const uint8_t* count_log_data(uint32_t* len);
+
+// Empties the log, e.g. after uploading it; the next record starts from
+// zero counts again
+void count_log_reset(void);
+
+// Returns the number of windows dropped because the log was full; once a
+// window does not fit, later ones are dropped too until count_log_reset()
+uint32_t count_log_dropped(void);
+
+#endif // COUNT_LOG_H
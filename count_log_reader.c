@@ -0,0 +1,92 @@
+#include <string.h>
+#include "count_log_reader.h"
+#include "count_log.h"
+
+static uint32_t get_u32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Returns the position after the varint, or NULL if it runs past end
+static const uint8_t* get_varint(const uint8_t* p, const uint8_t* end, uint32_t* value) {
+    uint32_t v = 0;
+    unsigned shift = 0;
+
+    while (p < end && shift < 32) {
+        uint8_t byte = *p++;
+        v |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *value = v;
+            return p;
+        }
+        shift += 7;
+    }
+    return NULL;
+}
+
+static uint32_t unzigzag(uint32_t v) {
+    return (v >> 1) ^ (0u - (v & 1u));
+}
+
+int count_log_reader_open(count_log_reader_t* reader, const uint8_t* data, size_t len) {
+    gpio_mask_t pins;
+    unsigned i;
+
+    if (len < COUNT_LOG_HEADER_SIZE || memcmp(data, COUNT_LOG_MAGIC, 4) != 0 ||
+        data[4] != COUNT_LOG_VERSION) {
+        return -1;
+    }
+    reader->pos = data + COUNT_LOG_HEADER_SIZE;
+    reader->end = data + len;
+    reader->pins = get_u32(data + 8);
+    reader->pin_count = 0;
+    for (pins = reader->pins; pins; pins &= pins - 1) {
+        ++reader->pin_count;
+    }
+    reader->timestamp = 0;
+    reader->delta = 0;
+    for (i = 0; i < 32; ++i) {
+        reader->counts[i] = 0;
+    }
+    return 0;
+}
+
+int count_log_reader_next(count_log_reader_t* reader, count_log_window_t* window) {
+    const uint8_t* p = reader->pos;
+    uint32_t value;
+    uint32_t run;
+    unsigned pin = 0;
+
+    if (p == reader->end) {
+        return 0;
+    }
+
+    p = get_varint(p, reader->end, &value);
+    if (p == NULL) {
+        return -1;
+    }
+    reader->delta += unzigzag(value);
+    reader->timestamp += reader->delta;
+
+    while (pin < reader->pin_count) {
+        p = get_varint(p, reader->end, &run);
+        if (p == NULL || run > reader->pin_count - pin) {
+            return -1;
+        }
+        pin += run;
+        if (pin == reader->pin_count) {
+            break;
+        }
+        p = get_varint(p, reader->end, &value);
+        if (p == NULL || value == 0) {
+            return -1;
+        }
+        reader->counts[pin++] += unzigzag(value);
+    }
+    reader->pos = p;
+
+    window->timestamp = reader->timestamp;
+    window->pins = reader->pins;
+    window->pin_count = reader->pin_count;
+    window->counts = reader->counts;
+    return 1;
+}
@@ -0,0 +1,35 @@
+#ifndef COUNT_LOG_READER_H
+#define COUNT_LOG_READER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "gpio_hal.h"
+
+// Sequential decoder for logs written by count_log.c, e.g. on the host after
+// an upload. Works directly on the log bytes.
+
+typedef struct {
+    uint32_t timestamp;     // gpio_read_timestamp() at the end of the window
+    gpio_mask_t pins;       // Logged pins
+    unsigned pin_count;
+    const uint32_t* counts; // counts[i] belongs to the i-th lowest logged pin
+} count_log_window_t;
+
+typedef struct {
+    const uint8_t* pos;
+    const uint8_t* end;
+    gpio_mask_t pins;
+    unsigned pin_count;
+    uint32_t timestamp;
+    uint32_t delta;
+    uint32_t counts[32];
+} count_log_reader_t;
+
+// Returns 0 on success, -1 if the data is not a supported log
+int count_log_reader_open(count_log_reader_t* reader, const uint8_t* data, size_t len);
+
+// Returns 1 if a window was decoded, 0 at the end of the log, -1 if corrupt.
+// The window's counts stay valid until the next call.
+int count_log_reader_next(count_log_reader_t* reader, count_log_window_t* window);
+
+#endif // COUNT_LOG_READER_H
@@ -1,56 +1,584 @@
+#include <stddef.h>
 #include "event_monitor.h"
 #include "gpio_hal.h"
+#include "pin_bits.h"
 #include "rtos_api.h"
 
 volatile uint32_t event_count = 0;
+// In-window rising edges per monitored pin, indexed by rank in the mask;
+// only counted once event_monitor_count_pins() enables them
+static volatile uint32_t pin_counts[32];
+static volatile uint8_t pin_counting = 0;
+// Odd while event_count and pin_counts are being updated; writers hold the lock
+static volatile uint32_t count_sequence = 0;
+#ifdef EVENT_MONITOR_STATIC_MASK
+// Fixed at build time so the callback works on a constant
+#define monitored_mask ((uint32_t)(EVENT_MONITOR_STATIC_MASK))
+#else
 static uint32_t monitored_mask = 0;
+#endif
 static gpio_mask_t previous_state = 0;
+static gpio_mask_t watched_pins = 0;  // Unmonitored pins observers need interrupts for
+static uint8_t watch_counts[32];      // Outstanding watches per pin
+static gpio_mask_t masked_pins = 0;   // Pins held off by event_monitor_mask_interrupts()
+static volatile uint32_t unmonitored_callbacks = 0;
 
-void gpio_change_callback(gpio_mask_t new_state) {
-    gpio_mask_t rising_edges;
+// Gated pins count only while their gate pin is at the given level
+typedef struct {
+    gpio_mask_t pin;
+    uint8_t gate;
+    uint8_t level;
+} gate_t;
+
+static gate_t gates[EVENT_MONITOR_MAX_GATES];
+static unsigned gate_count = 0;
+static gpio_mask_t gated_pins = 0;
+
+// Report sinks; empty slots are NULL
+static event_report_sink_t report_sinks[EVENT_MONITOR_MAX_REPORT_SINKS];
+
+// Reports are built alternately in these; holders counts the sinks that
+// have not released a report yet
+static event_report_t reports[2];
+static volatile uint8_t report_holders[2];
+static uint32_t report_sequence = 0;
+static uint32_t window_start = 0;
+static volatile uint32_t report_overruns = 0;
+
+// Registered observers; empty slots are NULL
+static const event_observer_t* volatile observers[EVENT_MONITOR_MAX_OBSERVERS];
+static volatile int observer_slots = 0;
+
+#ifdef EVENT_MONITOR_STATIC_MASK
+// One term per pin; the terms of unmonitored pins fold to 0, leaving
+// straight-line code that tests only the configured pins
+#define PIN_EDGE(edges, pin) \
+    (((monitored_mask >> (pin)) & 1u) ? (((edges) >> (pin)) & 1u) : 0u)
+#define PIN_EDGES_8(edges, base) \
+    (PIN_EDGE(edges, (base) + 0) + PIN_EDGE(edges, (base) + 1) + \
+     PIN_EDGE(edges, (base) + 2) + PIN_EDGE(edges, (base) + 3) + \
+     PIN_EDGE(edges, (base) + 4) + PIN_EDGE(edges, (base) + 5) + \
+     PIN_EDGE(edges, (base) + 6) + PIN_EDGE(edges, (base) + 7))
+
+// Counts the set bits of an edge mask
+static uint32_t count_edges(gpio_mask_t edges) {
+    return PIN_EDGES_8(edges, 0) + PIN_EDGES_8(edges, 8) +
+           PIN_EDGES_8(edges, 16) + PIN_EDGES_8(edges, 24);
+}
+#else
+// Counts the set bits of an edge mask
+static uint32_t count_edges(gpio_mask_t edges) {
+    uint32_t count = 0;
     int i;
 
+    for (i = 0; i < 32; ++i) {
+        if (edges & (1u << i)) {
+            ++count;
+        }
+    }
+    return count;
+}
+#endif
+
+// Pins whose edges count in this state: ungated pins, and gated pins whose
+// gate is at its level. Called under the lock, and only while gates are
+// set, so ungated builds keep the straight-line callback.
+static gpio_mask_t gate_enable(gpio_mask_t state) {
+    gpio_mask_t enable = ~gated_pins;
+    unsigned i;
+
+    for (i = 0; i < gate_count; ++i) {
+        // All ones when the gate is at its level, zero otherwise
+        gpio_mask_t open = 0u - (((state >> gates[i].gate) ^ gates[i].level ^ 1u) & 1u);
+        enable |= gates[i].pin & open;
+    }
+    return enable;
+}
+
+static void notify_change(int slots, const event_change_t* change) {
+    int i;
+
+    for (i = 0; i < slots; ++i) {
+        const event_observer_t* observer = observers[i];
+        if (observer && observer->on_change) {
+            observer->on_change(change);
+        }
+    }
+}
+
+// Shared by the callback and pollers; from_interrupt marks real callbacks
+static void process_state(gpio_mask_t new_state, int from_interrupt) {
+    gpio_mask_t rising_edges;
+    event_change_t change;
+    int slots = observer_slots;
+
+    // Take the timestamp first so observers see the time of the change
+    if (slots) {
+        change.timestamp = gpio_read_timestamp();
+    }
+
+    // Pollers feed this path too, so the previous state is only touched under the lock
+    rtos_mutex_lock();
     // Detect rising edges: bits that were 0 and are now 1, filtered by monitored mask
     rising_edges = (~previous_state & new_state) & monitored_mask;
+    if (gate_count) {
+        rising_edges &= gate_enable(new_state);
+    }
+    change.previous_state = previous_state;
     previous_state = new_state;
 
     if (rising_edges) {
-        rtos_mutex_lock();
         // Count the number of rising edges
-        for (i = 0; i < 32; ++i) {
-            if (rising_edges & (1u << i)) {
-                ++event_count;
+        ++count_sequence;
+        PIN_BITS_BARRIER();
+        event_count += count_edges(rising_edges);
+        if (pin_counting) {
+            pin_bits_count_ranked(pin_counts, monitored_mask, rising_edges);
+        }
+        PIN_BITS_BARRIER();
+        ++count_sequence;
+    } else if (from_interrupt && !((change.previous_state ^ new_state) & monitored_mask)) {
+        // No monitored pin changed: a watched pin or a spurious interrupt
+        ++unmonitored_callbacks;
+    }
+    rtos_mutex_unlock();
+
+    if (slots) {
+        change.new_state = new_state;
+        change.rising_edges = rising_edges;
+        notify_change(slots, &change);
+    }
+}
+
+void gpio_change_callback(gpio_mask_t new_state) {
+    process_state(new_state, 1);
+}
+
+void event_monitor_sample(gpio_mask_t state) {
+    process_state(state, 0);
+}
+
+void event_monitor_process_batch(const gpio_mask_t* states, const uint32_t* timestamps, uint32_t count) {
+    gpio_mask_t slice_previous[EVENT_MONITOR_BATCH_SLICE];
+    gpio_mask_t slice_edges[EVENT_MONITOR_BATCH_SLICE];
+    gpio_mask_t rising_edges;
+    event_change_t change;
+    uint32_t edges;
+    uint32_t start;
+    uint32_t end;
+    uint32_t n;
+    int slots = observer_slots;
+
+    change.timestamp = (slots && timestamps == NULL) ? gpio_read_timestamp() : 0;
+
+    for (start = 0; start < count; start = end) {
+        // Observers take the lock themselves, so they are notified between slices
+        end = (slots && count - start > EVENT_MONITOR_BATCH_SLICE) ? start + EVENT_MONITOR_BATCH_SLICE : count;
+        edges = 0;
+
+        // The previous state and the gates are shared with the callback and pollers
+        rtos_mutex_lock();
+        ++count_sequence;
+        PIN_BITS_BARRIER();
+        for (n = start; n < end; ++n) {
+            rising_edges = (~previous_state & states[n]) & monitored_mask;
+            if (gate_count) {
+                rising_edges &= gate_enable(states[n]);
             }
+            if (rising_edges) {
+                edges += count_edges(rising_edges);
+                if (pin_counting) {
+                    pin_bits_count_ranked(pin_counts, monitored_mask, rising_edges);
+                }
+            }
+            if (slots) {
+                slice_previous[n - start] = previous_state;
+                slice_edges[n - start] = rising_edges;
+            }
+            previous_state = states[n];
         }
+        event_count += edges;
+        PIN_BITS_BARRIER();
+        ++count_sequence;
         rtos_mutex_unlock();
+
+        if (slots) {
+            for (n = start; n < end; ++n) {
+                if (timestamps) {
+                    change.timestamp = timestamps[n];
+                }
+                change.previous_state = slice_previous[n - start];
+                change.new_state = states[n];
+                change.rising_edges = slice_edges[n - start];
+                notify_change(slots, &change);
+            }
+        }
     }
 }
 
-static void monitor_task(void* arg) {
+void event_monitor_report_window(void) {
+    event_report_t* report = &reports[report_sequence & 1u];
+    event_report_sink_t sinks[EVENT_MONITOR_MAX_REPORT_SINKS];
     uint32_t count;
-    
+    uint8_t holders = 0;
+    int i;
+
+    rtos_mutex_lock();
+    // The buffer last held the report of the window before the previous one
+    if (report_holders[report_sequence & 1u]) {
+        ++report_overruns;
+    }
+    report_holders[report_sequence & 1u] = 0;
+    rtos_mutex_unlock();
+
+    report->sequence = report_sequence++;
+    report->start_timestamp = window_start;
+    report->end_timestamp = gpio_read_timestamp();
+    window_start = report->end_timestamp;
+    report->active_pins = 0;
+
+    // Atomically read and reset the counters, building the report as we go
+    rtos_mutex_lock();
+    ++count_sequence;
+    PIN_BITS_BARRIER();
+    count = event_count;
+    event_count = 0;
+    pin_bits_expand(report->pin_counts, pin_counts, monitored_mask);
+    for (i = 0; i < 32; ++i) {
+        pin_counts[i] = 0;
+    }
+    PIN_BITS_BARRIER();
+    ++count_sequence;
+    rtos_mutex_unlock();
+    report->count = count;
+    for (i = 0; i < 32; ++i) {
+        if (report->pin_counts[i]) {
+            report->active_pins |= 1u << i;
+        }
+    }
+
+    // Report the count
+    report_event_count(count);
+
+    // Hold the report for every sink before the first can release it; the
+    // sinks called are the ones counted, whatever is added or removed meanwhile
+    rtos_mutex_lock();
+    for (i = 0; i < EVENT_MONITOR_MAX_REPORT_SINKS; ++i) {
+        if (report_sinks[i]) {
+            sinks[holders++] = report_sinks[i];
+        }
+    }
+    report_holders[report->sequence & 1u] = holders;
+    rtos_mutex_unlock();
+    for (i = 0; i < holders; ++i) {
+        sinks[i](report);
+    }
+
+    for (i = 0; i < observer_slots; ++i) {
+        const event_observer_t* observer = observers[i];
+        if (observer && observer->on_window) {
+            observer->on_window();
+        }
+    }
+}
+
+void event_monitor_release_report(const event_report_t* report) {
+    unsigned buffer;
+
+    // Anything but one of the two buffers, NULL included, is ignored
+    if (report == &reports[0]) {
+        buffer = 0;
+    } else if (report == &reports[1]) {
+        buffer = 1;
+    } else {
+        return;
+    }
+    rtos_mutex_lock();
+    if (report_holders[buffer]) {
+        --report_holders[buffer];
+    }
+    rtos_mutex_unlock();
+}
+
+uint32_t event_monitor_report_overruns(void) {
+    return report_overruns;
+}
+
+int event_monitor_add_report_sink(event_report_sink_t sink) {
+    int i;
+    int result = -1;
+
+    rtos_mutex_lock();
+    for (i = 0; i < EVENT_MONITOR_MAX_REPORT_SINKS; ++i) {
+        if (report_sinks[i] == NULL) {
+            report_sinks[i] = sink;
+            result = 0;
+            break;
+        }
+    }
+    rtos_mutex_unlock();
+
+    return result;
+}
+
+void event_monitor_remove_report_sink(event_report_sink_t sink) {
+    int i;
+
+    rtos_mutex_lock();
+    for (i = 0; i < EVENT_MONITOR_MAX_REPORT_SINKS; ++i) {
+        if (report_sinks[i] == sink) {
+            report_sinks[i] = NULL;
+        }
+    }
+    rtos_mutex_unlock();
+}
+
+void event_monitor_peek(event_snapshot_t* snapshot) {
+    uint32_t sequence;
+
+    // Copy without the lock and retry if a writer was active or got in between
+    do {
+        sequence = count_sequence;
+        PIN_BITS_BARRIER();
+        snapshot->count = event_count;
+        pin_bits_expand(snapshot->pin_counts, pin_counts, monitored_mask);
+        PIN_BITS_BARRIER();
+    } while ((sequence & 1u) || count_sequence != sequence);
+}
+
+void event_monitor_count_pins(int enable) {
+    int i;
+
+    rtos_mutex_lock();
+    // Consumers enable counting on init; that must not restart the others' window
+    if (pin_counting == (uint8_t)(enable != 0)) {
+        rtos_mutex_unlock();
+        return;
+    }
+    ++count_sequence;
+    PIN_BITS_BARRIER();
+    for (i = 0; i < 32; ++i) {
+        pin_counts[i] = 0;
+    }
+    pin_counting = (uint8_t)(enable != 0);
+    PIN_BITS_BARRIER();
+    ++count_sequence;
+    rtos_mutex_unlock();
+}
+
+void event_monitor_tick(void) {
+    int i;
+
+    for (i = 0; i < observer_slots; ++i) {
+        const event_observer_t* observer = observers[i];
+        if (observer && observer->on_tick) {
+            observer->on_tick();
+        }
+    }
+}
+
+static void monitor_task(void* arg) {
+    uint32_t ticks = 0;
+
     (void)arg; // Suppress unused parameter warning
     
     while (1) {
-        // Wait for 1000ms
-        rtos_task_delay_ms(1000);
+        rtos_task_delay_ms(EVENT_MONITOR_TICK_MS);
 
-        // Atomically read and reset the counter
-        rtos_mutex_lock();
-        count = event_count;
-        event_count = 0;
-        rtos_mutex_unlock();
+        event_monitor_tick();
+        if (++ticks == EVENT_MONITOR_WINDOW_MS / EVENT_MONITOR_TICK_MS) {
+            ticks = 0;
+            event_monitor_report_window();
+        }
+    }
+}
+
+uint32_t event_monitor_get_mask(void) {
+    return monitored_mask;
+}
+
+// Programs the HAL with the pins whose changes should raise the callback;
+// called under the lock
+static void update_interrupt_mask(void) {
+    gpio_set_interrupt_mask((monitored_mask | watched_pins) & ~masked_pins);
+}
+
+void event_monitor_set_mask(uint32_t mask) {
+#ifndef EVENT_MONITOR_STATIC_MASK
+    uint32_t by_pin[32];
+    uint32_t dense[32];
+    unsigned count;
+    unsigned i;
+#endif
+
+    rtos_mutex_lock();
+#ifdef EVENT_MONITOR_STATIC_MASK
+    (void)mask;
+#else
+    // Move the per-pin counts to their ranks in the new mask
+    ++count_sequence;
+    PIN_BITS_BARRIER();
+    pin_bits_expand(by_pin, pin_counts, monitored_mask);
+    count = pin_bits_gather(dense, by_pin, mask);
+    for (i = 0; i < 32; ++i) {
+        pin_counts[i] = i < count ? dense[i] : 0;
+    }
+    monitored_mask = mask;
+    PIN_BITS_BARRIER();
+    ++count_sequence;
+#endif
+    update_interrupt_mask();
+    rtos_mutex_unlock();
+}
+
+void event_monitor_watch_pins(gpio_mask_t pins) {
+    unsigned pin;
+
+    rtos_mutex_lock();
+    for (pin = 0; pin < 32; ++pin) {
+        // A saturated count keeps the pin watched for good
+        if (((pins >> pin) & 1u) && watch_counts[pin] < UINT8_MAX) {
+            ++watch_counts[pin];
+        }
+    }
+    watched_pins |= pins;
+    update_interrupt_mask();
+    rtos_mutex_unlock();
+}
+
+void event_monitor_unwatch_pins(gpio_mask_t pins) {
+    unsigned pin;
+
+    rtos_mutex_lock();
+    for (pin = 0; pin < 32; ++pin) {
+        if (((pins >> pin) & 1u) && watch_counts[pin] && watch_counts[pin] < UINT8_MAX) {
+            if (--watch_counts[pin] == 0) {
+                watched_pins &= ~(1u << pin);
+            }
+        }
+    }
+    update_interrupt_mask();
+    rtos_mutex_unlock();
+}
+
+void event_monitor_mask_interrupts(gpio_mask_t pins) {
+    rtos_mutex_lock();
+    masked_pins = pins;
+    update_interrupt_mask();
+    rtos_mutex_unlock();
+}
+
+void event_monitor_mask_interrupts_from(const volatile gpio_mask_t* pins) {
+    rtos_mutex_lock();
+    // Read here so the set and the HAL change in one step
+    masked_pins = *pins;
+    update_interrupt_mask();
+    rtos_mutex_unlock();
+}
+
+int event_monitor_set_gate(unsigned pin, unsigned gate_pin, int level) {
+    unsigned i;
+    int result = -1;
+
+    if (pin >= 32 || gate_pin >= 32) {
+        return -1;
+    }
+
+    rtos_mutex_lock();
+    for (i = 0; i < gate_count; ++i) {
+        if (gates[i].pin == (1u << pin)) {
+            break;
+        }
+    }
+    if (i < EVENT_MONITOR_MAX_GATES) {
+        gates[i].pin = 1u << pin;
+        gates[i].gate = (uint8_t)gate_pin;
+        gates[i].level = (uint8_t)(level != 0);
+        if (i == gate_count) {
+            ++gate_count;
+        }
+        gated_pins |= 1u << pin;
+        result = 0;
+    }
+    rtos_mutex_unlock();
+
+    return result;
+}
 
-        // Report the count
-        report_event_count(count);
+void event_monitor_clear_gate(unsigned pin) {
+    unsigned i;
+
+    rtos_mutex_lock();
+    for (i = 0; i < gate_count; ++i) {
+        if (gates[i].pin == (1u << pin)) {
+            gates[i] = gates[--gate_count];
+            gated_pins &= ~(1u << pin);
+            break;
+        }
     }
+    rtos_mutex_unlock();
+}
+
+uint32_t event_monitor_unmonitored_callbacks(void) {
+    return unmonitored_callbacks;
+}
+
+int event_monitor_add_observer(const event_observer_t* observer) {
+    int i;
+    int result = -1;
+
+    rtos_mutex_lock();
+    // Reuse a freed slot before growing the table
+    for (i = 0; i < observer_slots; ++i) {
+        if (observers[i] == NULL) {
+            observers[i] = observer;
+            result = 0;
+            break;
+        }
+    }
+    if (result != 0 && observer_slots < EVENT_MONITOR_MAX_OBSERVERS) {
+        observers[observer_slots] = observer;
+        // Publish the slot only after it is filled in
+        ++observer_slots;
+        result = 0;
+    }
+    rtos_mutex_unlock();
+
+    return result;
+}
+
+void event_monitor_remove_observer(const event_observer_t* observer) {
+    int i;
+
+    rtos_mutex_lock();
+    for (i = 0; i < observer_slots; ++i) {
+        if (observers[i] == observer) {
+            observers[i] = NULL;
+        }
+    }
+    // Shrink past trailing empty slots so the callback stops taking timestamps
+    while (observer_slots > 0 && observers[observer_slots - 1] == NULL) {
+        --observer_slots;
+    }
+    rtos_mutex_unlock();
 }
 
 void event_monitor_init(uint32_t mask) {
     static rtos_task_t task;
+    int i;
     
+#ifdef EVENT_MONITOR_STATIC_MASK
+    (void)mask;
+#else
     monitored_mask = mask;
+#endif
+    // Ranks follow the new mask
+    for (i = 0; i < 32; ++i) {
+        pin_counts[i] = 0;
+    }
     previous_state = gpio_read_input();
+    window_start = gpio_read_timestamp();
+    update_interrupt_mask();
     gpio_register_callback(gpio_change_callback);
 
     // Create the monitoring task
@@ -2,10 +2,189 @@
 #define EVENT_MONITOR_H
 
 #include <stdint.h>
+#include "gpio_hal.h"
+
+// Maximum number of observers that can be registered at once
+#define EVENT_MONITOR_MAX_OBSERVERS 8
+
+// Monitor task period; every tick runs the observers' on_tick hooks, and
+// every EVENT_MONITOR_WINDOW_MS closes a report window
+#ifndef EVENT_MONITOR_TICK_MS
+#define EVENT_MONITOR_TICK_MS 100
+#endif
+
+#ifndef EVENT_MONITOR_WINDOW_MS
+#define EVENT_MONITOR_WINDOW_MS 1000
+#endif
+
+#if EVENT_MONITOR_WINDOW_MS % EVENT_MONITOR_TICK_MS != 0
+#error "EVENT_MONITOR_WINDOW_MS must be a multiple of EVENT_MONITOR_TICK_MS"
+#endif
+
+// Maximum number of report sinks that can be registered at once
+#ifndef EVENT_MONITOR_MAX_REPORT_SINKS
+#define EVENT_MONITOR_MAX_REPORT_SINKS 8
+#endif
+
+// States walked per critical section by event_monitor_process_batch() while
+// observers are registered
+#ifndef EVENT_MONITOR_BATCH_SLICE
+#define EVENT_MONITOR_BATCH_SLICE 32
+#endif
+
+// Maximum number of gated pins
+#ifndef EVENT_MONITOR_MAX_GATES
+#define EVENT_MONITOR_MAX_GATES 8
+#endif
+
+// One GPIO change as seen by gpio_change_callback
+typedef struct {
+    uint32_t timestamp;          // gpio_read_timestamp() at callback entry
+    gpio_mask_t previous_state;  // Port state before this change
+    gpio_mask_t new_state;       // Port state after this change
+    gpio_mask_t rising_edges;    // Counted rising edges: monitored pins with open gates
+} event_change_t;
+
+// Counts of the report window in progress
+typedef struct {
+    uint32_t count;           // Rising edges so far, as report_event_count() would get
+    uint32_t pin_counts[32];  // The same per pin, if enabled with event_monitor_count_pins()
+} event_snapshot_t;
+
+// Report of one closed window. The monitor builds reports alternately in two
+// static buffers, so a report stays unchanged until the window after next
+// closes; sinks get a pointer to it and nothing is copied per sink.
+typedef struct {
+    uint32_t sequence;        // Windows closed before this one
+    uint32_t start_timestamp; // gpio_read_timestamp() when the window opened
+    uint32_t end_timestamp;   // gpio_read_timestamp() when it closed
+    uint32_t count;           // As passed to report_event_count()
+    gpio_mask_t active_pins;  // Pins with a non-zero entry in pin_counts
+    uint32_t pin_counts[32];  // Rising edges per pin, if enabled with event_monitor_count_pins()
+} event_report_t;
+
+// Receives each report from the monitor task. The report may be kept, e.g.
+// handed to another task, until the window after next closes, and should be
+// released with event_monitor_release_report() once done.
+typedef void (*event_report_sink_t)(const event_report_t* report);
+
+// Hooks into the monitor; any function pointer may be NULL
+typedef struct {
+    // Called from gpio_change_callback (interrupt context) for every change
+    void (*on_change)(const event_change_t* change);
+    // Called from the monitor task after each report_event_count()
+    void (*on_window)(void);
+    // Called from the monitor task every EVENT_MONITOR_TICK_MS
+    void (*on_tick)(void);
+} event_observer_t;
+
+// Builds may fix the monitored pins with -DEVENT_MONITOR_STATIC_MASK=<mask>.
+// The callback then works on a constant mask and counts edges with
+// straight-line code for the configured pins only, with the same results as
+// the generic build (per-pin counts and gates, when enabled, add a loop);
+// the mask arguments of event_monitor_init() and
+// event_monitor_set_mask() are ignored.
 
 // Initialize the event monitor with a bitmask of pins to monitor
 void event_monitor_init(uint32_t monitored_mask);
 
+// Returns the bitmask of monitored pins
+uint32_t event_monitor_get_mask(void);
+
+// Replaces the bitmask of monitored pins and reprograms the interrupt mask
+void event_monitor_set_mask(uint32_t monitored_mask);
+
+// Keeps change interrupts enabled for pins an observer needs even though they
+// are not counted. Pins accumulate over calls; each pin stays watched until
+// every watch of it has been undone with event_monitor_unwatch_pins().
+void event_monitor_watch_pins(gpio_mask_t pins);
+
+// Undoes one event_monitor_watch_pins() of the given pins
+void event_monitor_unwatch_pins(gpio_mask_t pins);
+
+// Registers an observer; returns 0 on success, -1 if the table is full
+int event_monitor_add_observer(const event_observer_t* observer);
+
+// Unregisters a previously added observer
+void event_monitor_remove_observer(const event_observer_t* observer);
+
+// Processes consecutive port states as if each had arrived through
+// gpio_change_callback. The states are walked under the lock shared with the
+// callback and pollers: once for the whole batch, or once per
+// EVENT_MONITOR_BATCH_SLICE states while observers are registered, as they
+// are notified outside it. timestamps may be NULL, in which case the whole
+// batch shares one gpio_read_timestamp() value.
+void event_monitor_process_batch(const gpio_mask_t* states, const uint32_t* timestamps, uint32_t count);
+
+// Feeds one port state read by polling. The callback and pollers share the
+// previous state under the lock, so each edge is counted once by whichever
+// path sees it first. Call from task context.
+void event_monitor_sample(gpio_mask_t state);
+
+// Disables change interrupts for the given pins, replacing the previous set;
+// pins masked this way are only seen through other callbacks or polling.
+// Interrupts are otherwise enabled for the monitored and watched pins only.
+void event_monitor_mask_interrupts(gpio_mask_t pins);
+
+// Like event_monitor_mask_interrupts(), but reads the set from *pins under
+// the lock. Callers that change *pins under the lock from both the callback
+// and a task call this after every change: whichever call runs last programs
+// the latest set, so a preempted caller cannot restore an older one.
+void event_monitor_mask_interrupts_from(const volatile gpio_mask_t* pins);
+
+// Counts rising edges on pin only while gate_pin reads level (0 or 1) in
+// the same port state, like a hardware counter's gate input; replaces any
+// gate already set for pin. Returns 0 on success, -1 on an invalid pin or a
+// full gate table.
+int event_monitor_set_gate(unsigned pin, unsigned gate_pin, int level);
+
+// Counts pin unconditionally again
+void event_monitor_clear_gate(unsigned pin);
+
+// Returns the number of callbacks in which no monitored pin changed; with the
+// interrupt mask in place these come from watched pins or spurious interrupts
+uint32_t event_monitor_unmonitored_callbacks(void);
+
+// Closes the current report window: reads and resets the counts, reports the
+// aggregate, passes the window's report to the report sinks and runs the
+// observers' on_window hooks. The monitor task calls this every
+// EVENT_MONITOR_WINDOW_MS; hosts that drive time themselves (replay, tests)
+// may call it directly.
+void event_monitor_report_window(void);
+
+// Registers a report sink; returns 0 on success, -1 if the table is full
+int event_monitor_add_report_sink(event_report_sink_t sink);
+
+// Unregisters a previously added report sink
+void event_monitor_remove_report_sink(event_report_sink_t sink);
+
+// Tells the monitor one sink is done with a report. A report still held by
+// a sink when its buffer is reused counts as an overrun. Pointers other than
+// a report passed to a sink are ignored.
+void event_monitor_release_report(const event_report_t* report);
+
+// Returns the number of reports overwritten while a sink still held them
+uint32_t event_monitor_report_overruns(void);
+
+// Enables (1) or disables (0) counting rising edges per monitored pin for
+// snapshots and reports. Off by default, as it costs the callback a loop over
+// the rising edges; counters are dense, one per monitored pin in pin order.
+// Per-pin consumers (pin_counters, window_history, count_log) read these
+// counters from the reports and enable them on init. Switching restarts the
+// per-pin counts of the window in progress; enabling again changes nothing.
+void event_monitor_count_pins(int enable);
+
+// Copies the counts of the window in progress without resetting them. Takes
+// no lock: the copy is retried if a change is counted meanwhile, so the
+// callback is never held up and the snapshot is consistent. Call from task
+// context only: from an interrupt that preempted a counting task (a poller,
+// a batch or the window close) it would retry forever.
+void event_monitor_peek(event_snapshot_t* snapshot);
+
+// Runs the observers' on_tick hooks. The monitor task calls this every
+// EVENT_MONITOR_TICK_MS; hosts that drive time themselves may call it directly.
+void event_monitor_tick(void);
+
 // User-implemented function to handle event count reports
 void report_event_count(uint32_t count);
 
@@ -0,0 +1,175 @@
+#ifndef EVENT_MONITOR_HPP
+#define EVENT_MONITOR_HPP
+
+// Header-only C++17 front-end to the event monitor logic. Each EventMonitor
+// instance owns its state, so several configurations can run side by side
+// (e.g. in a host simulator), and the port width, lock policy, edge mode and
+// mask are template parameters, so each specialization compiles down to the
+// same straight-line code as a hand-written C callback. With a 32-bit port,
+// the mutex policy and rising edges it counts exactly what event_monitor.c does.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+extern "C" {
+#include "rtos_api.h"
+}
+
+namespace event_monitor {
+
+enum class EdgeMode {
+    Rising,
+    Falling,
+    Both
+};
+
+// Port state type for a port width in bits
+template <unsigned Width>
+struct PortWord;
+
+template <>
+struct PortWord<8> {
+    using type = std::uint8_t;
+};
+
+template <>
+struct PortWord<16> {
+    using type = std::uint16_t;
+};
+
+template <>
+struct PortWord<32> {
+    using type = std::uint32_t;
+};
+
+template <>
+struct PortWord<64> {
+    using type = std::uint64_t;
+};
+
+// Lock policies: how the callback's count is published to the reporting side
+
+// Guards the counter with the RTOS mutex, as event_monitor.c does
+struct MutexLock {
+    using Counter = std::uint32_t;
+
+    static void add(Counter& counter, std::uint32_t edges) noexcept {
+        rtos_mutex_lock();
+        counter += edges;
+        rtos_mutex_unlock();
+    }
+
+    static std::uint32_t take(Counter& counter) noexcept {
+        rtos_mutex_lock();
+        std::uint32_t count = counter;
+        counter = 0;
+        rtos_mutex_unlock();
+        return count;
+    }
+};
+
+// Lock-free counter; needs a target with atomic read-modify-write
+struct AtomicLock {
+    using Counter = std::atomic<std::uint32_t>;
+
+    static void add(Counter& counter, std::uint32_t edges) noexcept {
+        counter.fetch_add(edges, std::memory_order_relaxed);
+    }
+
+    static std::uint32_t take(Counter& counter) noexcept {
+        return counter.exchange(0, std::memory_order_relaxed);
+    }
+};
+
+// No synchronization, for single-threaded hosts
+struct NoLock {
+    using Counter = std::uint32_t;
+
+    static void add(Counter& counter, std::uint32_t edges) noexcept {
+        counter += edges;
+    }
+
+    static std::uint32_t take(Counter& counter) noexcept {
+        std::uint32_t count = counter;
+        counter = 0;
+        return count;
+    }
+};
+
+template <unsigned Width, typename LockPolicy, EdgeMode Mode,
+          typename PortWord<Width>::type Mask = static_cast<typename PortWord<Width>::type>(~0ull)>
+class EventMonitor {
+public:
+    using word_type = typename PortWord<Width>::type;
+
+    static constexpr word_type mask = Mask;
+    static constexpr EdgeMode mode = Mode;
+
+    // Bits of the counted edges between two port states
+    static constexpr word_type edges(word_type previous, word_type next) noexcept {
+        if constexpr (Mode == EdgeMode::Rising) {
+            return static_cast<word_type>(~previous & next & Mask);
+        } else if constexpr (Mode == EdgeMode::Falling) {
+            return static_cast<word_type>(previous & ~next & Mask);
+        } else {
+            return static_cast<word_type>((previous ^ next) & Mask);
+        }
+    }
+
+    static constexpr std::uint32_t count_edges(word_type bits) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<std::uint32_t>(__builtin_popcountll(bits));
+#else
+        std::uint32_t count = 0;
+        for (; bits; bits &= static_cast<word_type>(bits - 1)) {
+            ++count;
+        }
+        return count;
+#endif
+    }
+
+    explicit EventMonitor(word_type initial_state = 0) noexcept
+        : previous_state_(initial_state), count_(0) {}
+
+    EventMonitor(const EventMonitor&) = delete;
+    EventMonitor& operator=(const EventMonitor&) = delete;
+
+    // Equivalent of gpio_change_callback; call from a single context
+    void on_change(word_type new_state) noexcept {
+        word_type bits = edges(previous_state_, new_state);
+        previous_state_ = new_state;
+        if (bits) {
+            LockPolicy::add(count_, count_edges(bits));
+        }
+    }
+
+    // Equivalent of event_monitor_process_batch, publishing once per batch
+    void process_batch(const word_type* states, std::size_t count) noexcept {
+        std::uint32_t total = 0;
+        for (std::size_t n = 0; n < count; ++n) {
+            total += count_edges(edges(previous_state_, states[n]));
+            previous_state_ = states[n];
+        }
+        if (total) {
+            LockPolicy::add(count_, total);
+        }
+    }
+
+    // Reads and resets the count, as each report window does
+    std::uint32_t take_count() noexcept {
+        return LockPolicy::take(count_);
+    }
+
+    word_type previous_state() const noexcept {
+        return previous_state_;
+    }
+
+private:
+    word_type previous_state_;
+    typename LockPolicy::Counter count_;
+};
+
+} // namespace event_monitor
+
+#endif // EVENT_MONITOR_HPP
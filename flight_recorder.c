@@ -0,0 +1,76 @@
+#include <stddef.h>
+#include "flight_recorder.h"
+#include "event_monitor.h"
+
+#if (FLIGHT_RECORDER_DEPTH & (FLIGHT_RECORDER_DEPTH - 1)) != 0
+#error "FLIGHT_RECORDER_DEPTH must be a power of two"
+#endif
+
+#ifdef FLIGHT_RECORDER_SECTION
+#define FLIGHT_RECORDER_PLACEMENT __attribute__((section(FLIGHT_RECORDER_SECTION)))
+#else
+#define FLIGHT_RECORDER_PLACEMENT
+#endif
+
+// Marks a ring that holds valid history; stored with its complement so that
+// random power-up RAM contents are not mistaken for it
+#define FLIGHT_RECORDER_MAGIC 0x464C5452u
+
+typedef struct {
+    uint32_t magic;
+    uint32_t magic_check;
+    uint32_t index;              // Entries written, wraps freely
+    flight_recorder_entry_t entries[FLIGHT_RECORDER_DEPTH];
+} flight_recorder_t;
+
+static flight_recorder_t recorder FLIGHT_RECORDER_PLACEMENT;
+
+static void flight_recorder_on_change(const event_change_t* change);
+
+static const event_observer_t flight_recorder_observer = {
+    flight_recorder_on_change,
+    NULL,
+    NULL
+};
+
+static void flight_recorder_on_change(const event_change_t* change) {
+    flight_recorder_entry_t* entry = &recorder.entries[recorder.index & (FLIGHT_RECORDER_DEPTH - 1)];
+
+    entry->timestamp = change->timestamp;
+    entry->new_state = change->new_state;
+    entry->rising_edges = change->rising_edges;
+    ++recorder.index;
+}
+
+int flight_recorder_init(uint32_t* recovered) {
+    uint32_t kept = 0;
+
+    if (recorder.magic == FLIGHT_RECORDER_MAGIC && recorder.magic_check == ~FLIGHT_RECORDER_MAGIC) {
+        kept = recorder.index < FLIGHT_RECORDER_DEPTH ? recorder.index : FLIGHT_RECORDER_DEPTH;
+    } else {
+        recorder.index = 0;
+        recorder.magic = FLIGHT_RECORDER_MAGIC;
+        recorder.magic_check = ~FLIGHT_RECORDER_MAGIC;
+    }
+    if (recovered) {
+        *recovered = kept;
+    }
+
+    // Observers survive in RAM only without a reset; never register twice
+    event_monitor_remove_observer(&flight_recorder_observer);
+    return event_monitor_add_observer(&flight_recorder_observer);
+}
+
+uint32_t flight_recorder_dump(flight_recorder_entry_t* entries, uint32_t max) {
+    uint32_t end = recorder.index;
+    uint32_t count = end < FLIGHT_RECORDER_DEPTH ? end : FLIGHT_RECORDER_DEPTH;
+    uint32_t i;
+
+    if (count > max) {
+        count = max;
+    }
+    for (i = 0; i < count; ++i) {
+        entries[i] = recorder.entries[(end - count + i) & (FLIGHT_RECORDER_DEPTH - 1)];
+    }
+    return count;
+}
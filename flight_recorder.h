@@ -0,0 +1,37 @@
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include <stdint.h>
+#include "gpio_hal.h"
+
+// Always-on record of the last FLIGHT_RECORDER_DEPTH callbacks for
+// post-mortem analysis. Each callback costs three stores and one index
+// increment into a statically allocated ring.
+//
+// Define FLIGHT_RECORDER_SECTION to the name of a linker section that startup
+// code does not clear (for example ".noinit") to keep the ring across a warm
+// reset; flight_recorder_init() then recovers the previous history.
+
+// Ring depth in entries; must be a power of two
+#ifndef FLIGHT_RECORDER_DEPTH
+#define FLIGHT_RECORDER_DEPTH 64
+#endif
+
+typedef struct {
+    uint32_t timestamp;
+    gpio_mask_t new_state;
+    gpio_mask_t rising_edges;
+} flight_recorder_entry_t;
+
+// Starts recording. Sets *recovered, unless NULL, to how many entries
+// survived from before a warm reset (0 after a cold boot); dump them before
+// GPIO activity resumes. Returns 0 on success, -1 if the observer table is
+// full, in which case nothing new is recorded but the history is kept.
+int flight_recorder_init(uint32_t* recovered);
+
+// Copies up to max of the most recent entries, oldest first, and returns the
+// number copied. Safe from a fault handler; call it with the GPIO interrupt
+// masked for a consistent snapshot.
+uint32_t flight_recorder_dump(flight_recorder_entry_t* entries, uint32_t max);
+
+#endif // FLIGHT_RECORDER_H
@@ -0,0 +1,138 @@
+#include <stddef.h>
+#include "gpio_capture.h"
+#include "event_monitor.h"
+#include "pin_bits.h"
+
+#if (GPIO_CAPTURE_DEPTH & (GPIO_CAPTURE_DEPTH - 1)) != 0
+#error "GPIO_CAPTURE_DEPTH must be a power of two"
+#endif
+
+static gpio_capture_sample_t ring[GPIO_CAPTURE_DEPTH];
+static uint32_t head = 0;              // Samples written since arming
+static volatile uint8_t status = GPIO_CAPTURE_IDLE;
+
+static gpio_capture_trigger_t trigger;
+static uint32_t pre_samples = 0;
+static uint32_t post_samples = 0;
+static uint32_t post_remaining = 0;
+static uint32_t trigger_index = 0;
+
+// GPIO_TRIGGER_RATE bookkeeping
+static uint32_t rate_window_start = 0;
+static uint32_t rate_count = 0;
+
+static gpio_mask_t watched_mask = 0;  // Trigger pins watched while armed
+static int registered = 0;
+
+static void capture_on_change(const event_change_t* change);
+
+static const event_observer_t capture_observer = {
+    capture_on_change,
+    NULL,
+    NULL
+};
+
+static int check_trigger(const event_change_t* change) {
+    switch (trigger.type) {
+    case GPIO_TRIGGER_PATTERN:
+        return (change->new_state & trigger.mask) == trigger.value;
+    case GPIO_TRIGGER_RISING:
+        return (~change->previous_state & change->new_state & trigger.mask) != 0;
+    case GPIO_TRIGGER_FALLING:
+        return (change->previous_state & ~change->new_state & trigger.mask) != 0;
+    case GPIO_TRIGGER_RATE:
+        if ((uint32_t)(change->timestamp - rate_window_start) >= trigger.window) {
+            rate_window_start = change->timestamp;
+            rate_count = 0;
+        }
+        rate_count += pin_bits_count(~change->previous_state & change->new_state & trigger.mask);
+        return rate_count >= trigger.threshold;
+    }
+    return 0;
+}
+
+static void capture_on_change(const event_change_t* change) {
+    gpio_capture_sample_t* sample;
+
+    if (status != GPIO_CAPTURE_ARMED && status != GPIO_CAPTURE_TRIGGERED) {
+        return;
+    }
+
+    // The recording itself: two stores and an index increment
+    sample = &ring[head & (GPIO_CAPTURE_DEPTH - 1)];
+    sample->timestamp = change->timestamp;
+    sample->state = change->new_state;
+    ++head;
+
+    if (status == GPIO_CAPTURE_ARMED) {
+        if (check_trigger(change)) {
+            trigger_index = head - 1;
+            post_remaining = post_samples;
+            status = (uint8_t)(post_remaining ? GPIO_CAPTURE_TRIGGERED : GPIO_CAPTURE_DONE);
+        }
+    } else if (--post_remaining == 0) {
+        status = GPIO_CAPTURE_DONE;
+    }
+}
+
+int gpio_capture_arm(const gpio_capture_trigger_t* config, uint32_t pre, uint32_t post) {
+    if (config == NULL || pre >= GPIO_CAPTURE_DEPTH || post >= GPIO_CAPTURE_DEPTH - pre) {
+        return -1;
+    }
+    if (config->type == GPIO_TRIGGER_RATE && (config->threshold == 0 || config->window == 0)) {
+        return -1;
+    }
+
+    // Stop the callback from recording while the settings change
+    gpio_capture_disarm();
+    trigger = *config;
+    pre_samples = pre;
+    post_samples = post;
+    head = 0;
+    rate_count = 0;
+    rate_window_start = gpio_read_timestamp();
+
+    if (!registered) {
+        if (event_monitor_add_observer(&capture_observer) != 0) {
+            return -1;
+        }
+        registered = 1;
+    }
+    watched_mask = trigger.mask;
+    event_monitor_watch_pins(watched_mask);
+    status = GPIO_CAPTURE_ARMED;
+    return 0;
+}
+
+void gpio_capture_disarm(void) {
+    status = GPIO_CAPTURE_IDLE;
+    event_monitor_unwatch_pins(watched_mask);
+    watched_mask = 0;
+}
+
+gpio_capture_status_t gpio_capture_status(void) {
+    return (gpio_capture_status_t)status;
+}
+
+uint32_t gpio_capture_read(gpio_capture_sample_t* samples, uint32_t max, uint32_t* trigger_pos) {
+    uint32_t first;
+    uint32_t count;
+    uint32_t i;
+
+    if (status != GPIO_CAPTURE_DONE) {
+        return 0;
+    }
+    // Fewer pre-trigger samples exist if the trigger hit soon after arming
+    first = trigger_index >= pre_samples ? trigger_index - pre_samples : 0;
+    count = head - first;
+    if (count > max) {
+        count = max;
+    }
+    for (i = 0; i < count; ++i) {
+        samples[i] = ring[(first + i) & (GPIO_CAPTURE_DEPTH - 1)];
+    }
+    if (trigger_pos) {
+        *trigger_pos = trigger_index - first;
+    }
+    return count;
+}
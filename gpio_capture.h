@@ -0,0 +1,60 @@
+#ifndef GPIO_CAPTURE_H
+#define GPIO_CAPTURE_H
+
+#include <stdint.h>
+#include "gpio_hal.h"
+
+// Logic-analyzer-style triggered capture. While armed, every change is
+// stored with its timestamp in a fixed ring; when the trigger condition hits,
+// recording continues for the requested post-trigger samples and the ring is
+// then frozen until it is read out or re-armed.
+
+// Ring depth in samples; must be a power of two
+#ifndef GPIO_CAPTURE_DEPTH
+#define GPIO_CAPTURE_DEPTH 256
+#endif
+
+typedef enum {
+    GPIO_TRIGGER_PATTERN,   // (new_state & mask) == value
+    GPIO_TRIGGER_RISING,    // Rising edge on any pin in mask
+    GPIO_TRIGGER_FALLING,   // Falling edge on any pin in mask
+    GPIO_TRIGGER_RATE       // At least threshold rising edges on mask within window ticks
+} gpio_trigger_type_t;
+
+typedef struct {
+    gpio_trigger_type_t type;
+    gpio_mask_t mask;
+    gpio_mask_t value;      // GPIO_TRIGGER_PATTERN only
+    uint32_t threshold;     // GPIO_TRIGGER_RATE only
+    uint32_t window;        // GPIO_TRIGGER_RATE only, in timestamp ticks
+} gpio_capture_trigger_t;
+
+typedef enum {
+    GPIO_CAPTURE_IDLE,
+    GPIO_CAPTURE_ARMED,     // Recording, waiting for the trigger
+    GPIO_CAPTURE_TRIGGERED, // Recording post-trigger samples
+    GPIO_CAPTURE_DONE       // Frozen, ready to read
+} gpio_capture_status_t;
+
+typedef struct {
+    uint32_t timestamp;
+    gpio_mask_t state;
+} gpio_capture_sample_t;
+
+// Arms the capture. pre + post + 1 (the trigger sample) must fit in the ring.
+// The trigger pins keep raising the callback until the capture is disarmed or
+// re-armed. Returns 0 on success, -1 on an invalid request or a full observer
+// table.
+int gpio_capture_arm(const gpio_capture_trigger_t* trigger, uint32_t pre, uint32_t post);
+
+// Stops recording without a trigger and releases the trigger pins'
+// interrupts; a frozen capture is dropped
+void gpio_capture_disarm(void);
+
+gpio_capture_status_t gpio_capture_status(void);
+
+// Copies the frozen capture, oldest first, and sets *trigger_pos to the index
+// of the trigger sample. Returns the number of samples copied, 0 unless done.
+uint32_t gpio_capture_read(gpio_capture_sample_t* samples, uint32_t max, uint32_t* trigger_pos);
+
+#endif // GPIO_CAPTURE_H
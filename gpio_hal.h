@@ -11,4 +11,11 @@ gpio_mask_t gpio_read_input(void);
 // Registers a callback to be called on GPIO change
 void gpio_register_callback(void (*callback)(gpio_mask_t new_state));
 
+// Reads a free-running 32-bit timestamp counter (wraps around)
+uint32_t gpio_read_timestamp(void);
+
+// Enables change interrupts for the pins set in mask only; changes on other
+// pins still show in gpio_read_input() and in later callbacks' new_state
+void gpio_set_interrupt_mask(gpio_mask_t mask);
+
 #endif // GPIO_HAL_H
\ No newline at end of file
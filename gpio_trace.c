@@ -0,0 +1,223 @@
+#include <stddef.h>
+#include "gpio_trace.h"
+#include "event_monitor.h"
+#include "gpio_hal.h"
+
+// Block buffer ownership: the ISR fills one block while the task flushes the other
+enum {
+    TRACE_FREE = 0,
+    TRACE_FILLING,
+    TRACE_READY
+};
+
+typedef struct {
+    uint8_t data[GPIO_TRACE_BLOCK_SIZE];
+    uint32_t len;              // Bytes used, block header included
+    uint32_t count;
+    uint64_t base_timestamp;
+    gpio_mask_t base_state;
+    uint32_t dropped;
+    volatile uint8_t status;
+} trace_block_t;
+
+static trace_block_t blocks[2];
+static uint8_t active = 0;
+static volatile uint8_t recording = 0;
+
+static gpio_mask_t trace_mask = 0;
+static gpio_trace_sink_t trace_sink = NULL;
+static void* trace_ctx = NULL;
+
+static uint32_t last_timestamp = 0;   // Raw counter value at the last callback
+static uint64_t now = 0;              // Extended time at the last callback
+static uint64_t last_record_time = 0;
+static gpio_mask_t last_state = 0;
+static uint32_t pending_dropped = 0;  // Dropped since the last block was opened
+static uint32_t total_dropped = 0;
+
+static void trace_on_change(const event_change_t* change);
+
+static const event_observer_t trace_observer = {
+    trace_on_change,
+    gpio_trace_flush,
+    NULL
+};
+
+static void put_u32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static uint8_t* put_varint(uint8_t* p, uint64_t v) {
+    while (v >= 0x80) {
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+static void open_block(trace_block_t* blk) {
+    blk->len = GPIO_TRACE_BLOCK_HEADER_SIZE;
+    blk->count = 0;
+    blk->base_timestamp = last_record_time;
+    blk->base_state = last_state;
+    blk->dropped = pending_dropped;
+    pending_dropped = 0;
+    blk->status = TRACE_FILLING;
+}
+
+static void trace_on_change(const event_change_t* change) {
+    trace_block_t* blk;
+    gpio_mask_t state;
+    uint8_t* p;
+    int next;
+
+    if (!recording) {
+        return;
+    }
+
+    // Keep time running on every callback so the 32-bit counter never wraps unseen
+    now += (uint32_t)(change->timestamp - last_timestamp);
+    last_timestamp = change->timestamp;
+
+    state = change->new_state & trace_mask;
+    if (state == last_state) {
+        return;
+    }
+
+    blk = &blocks[active];
+    if (blk->status == TRACE_FILLING && blk->len + GPIO_TRACE_MAX_RECORD_SIZE > GPIO_TRACE_BLOCK_SIZE) {
+        // Hand the full block over to the flushing task
+        blk->status = TRACE_READY;
+    }
+    if (blk->status != TRACE_FILLING) {
+        next = active ^ 1;
+        if (blocks[next].status != TRACE_FREE) {
+            next = active;
+        }
+        if (blocks[next].status != TRACE_FREE) {
+            // Both buffers await flushing: drop the record but keep the state
+            // current so the next block starts from the right base
+            ++pending_dropped;
+            ++total_dropped;
+            last_state = state;
+            last_record_time = now;
+            return;
+        }
+        active = (uint8_t)next;
+        blk = &blocks[next];
+        open_block(blk);
+    }
+
+    p = blk->data + blk->len;
+    p = put_varint(p, now - last_record_time);
+    p = put_varint(p, state ^ last_state);
+    blk->len = (uint32_t)(p - blk->data);
+    ++blk->count;
+
+    last_state = state;
+    last_record_time = now;
+}
+
+static void write_block(trace_block_t* blk) {
+    put_u32(blk->data + 0, blk->len - GPIO_TRACE_BLOCK_HEADER_SIZE);
+    put_u32(blk->data + 4, blk->count);
+    put_u32(blk->data + 8, (uint32_t)blk->base_timestamp);
+    put_u32(blk->data + 12, (uint32_t)(blk->base_timestamp >> 32));
+    put_u32(blk->data + 16, blk->base_state);
+    put_u32(blk->data + 20, blk->dropped);
+    trace_sink(blk->data, blk->len, trace_ctx);
+    blk->status = TRACE_FREE;
+}
+
+void gpio_trace_flush(void) {
+    uint8_t newest = active;
+
+    if (trace_sink == NULL) {
+        return;
+    }
+    // The block that is not active is always the older one
+    if (blocks[newest ^ 1].status == TRACE_READY) {
+        write_block(&blocks[newest ^ 1]);
+    }
+    if (blocks[newest].status == TRACE_READY) {
+        write_block(&blocks[newest]);
+    }
+}
+
+int gpio_trace_start(gpio_mask_t mask, uint32_t clock_hz, gpio_trace_sink_t sink, void* ctx) {
+    uint8_t header[GPIO_TRACE_HEADER_SIZE];
+
+    if (recording || sink == NULL) {
+        return -1;
+    }
+
+    // The callback ignores changes until recording is set below
+    if (event_monitor_add_observer(&trace_observer) != 0) {
+        return -1;
+    }
+
+    trace_mask = mask;
+    trace_sink = sink;
+    trace_ctx = ctx;
+
+    header[0] = GPIO_TRACE_MAGIC[0];
+    header[1] = GPIO_TRACE_MAGIC[1];
+    header[2] = GPIO_TRACE_MAGIC[2];
+    header[3] = GPIO_TRACE_MAGIC[3];
+    header[4] = GPIO_TRACE_VERSION;
+    header[5] = (uint8_t)(sizeof(gpio_mask_t) * 8);
+    header[6] = (uint8_t)GPIO_TRACE_HEADER_SIZE;
+    header[7] = 0;
+    put_u32(header + 8, mask);
+    put_u32(header + 12, clock_hz);
+    trace_sink(header, sizeof(header), trace_ctx);
+
+    last_timestamp = gpio_read_timestamp();
+    now = last_timestamp;
+    last_record_time = now;
+    last_state = gpio_read_input() & mask;
+    pending_dropped = 0;
+    total_dropped = 0;
+    blocks[0].status = TRACE_FREE;
+    blocks[1].status = TRACE_FREE;
+    active = 0;
+    open_block(&blocks[0]);
+
+    event_monitor_watch_pins(mask);
+    recording = 1;
+    return 0;
+}
+
+void gpio_trace_stop(void) {
+    trace_block_t* blk;
+
+    if (!recording) {
+        return;
+    }
+    // Once cleared, no callback touches the buffers again
+    recording = 0;
+    event_monitor_remove_observer(&trace_observer);
+    event_monitor_unwatch_pins(trace_mask);
+
+    blk = &blocks[active];
+    if (blk->status == TRACE_FILLING) {
+        blk->status = (blk->count || blk->dropped) ? TRACE_READY : TRACE_FREE;
+    }
+    gpio_trace_flush();
+
+    // Record a trailing drop so the reader knows the trace lost its tail
+    if (pending_dropped) {
+        blk = &blocks[active];
+        open_block(blk);
+        blk->status = TRACE_READY;
+        gpio_trace_flush();
+    }
+}
+
+uint32_t gpio_trace_dropped(void) {
+    return total_dropped;
+}
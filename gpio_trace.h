@@ -0,0 +1,61 @@
+#ifndef GPIO_TRACE_H
+#define GPIO_TRACE_H
+
+#include <stdint.h>
+#include "gpio_hal.h"
+
+// Binary GPIO trace format (all integers little-endian):
+//
+//   File header (GPIO_TRACE_HEADER_SIZE bytes)
+//     char[4]  magic "GTRC"
+//     uint8    version
+//     uint8    port width in bits
+//     uint16   header size
+//     uint32   traced pin mask
+//     uint32   timestamp clock rate in Hz
+//
+//   Blocks, one per half of the recorder's double buffer
+//     uint32   payload size in bytes
+//     uint32   record count
+//     uint64   base timestamp (ticks, extended to 64 bits)
+//     uint32   base state (traced pins before the first record)
+//     uint32   records dropped just before this block
+//     payload: per record varint(timestamp delta), varint(state XOR previous)
+//
+// Each block carries its own base timestamp and state, so blocks decode
+// independently of each other.
+
+#define GPIO_TRACE_MAGIC "GTRC"
+#define GPIO_TRACE_VERSION 1
+#define GPIO_TRACE_HEADER_SIZE 16
+#define GPIO_TRACE_BLOCK_HEADER_SIZE 24
+
+// Worst-case record size: 64-bit varint delta plus 32-bit varint XOR
+#define GPIO_TRACE_MAX_RECORD_SIZE 15
+
+// Size of each half of the recorder's double buffer, block header included
+#ifndef GPIO_TRACE_BLOCK_SIZE
+#define GPIO_TRACE_BLOCK_SIZE 1024
+#endif
+
+// Receives encoded trace bytes; called from task context only
+typedef void (*gpio_trace_sink_t)(const uint8_t* data, uint32_t len, void* ctx);
+
+// Starts recording changes on the pins in mask. Writes the file header to the
+// sink and hooks the recorder into the event monitor's callback path.
+// Returns 0 on success, -1 if a recording is already in progress or the
+// observer table is full, in which case nothing is written.
+int gpio_trace_start(gpio_mask_t mask, uint32_t clock_hz, gpio_trace_sink_t sink, void* ctx);
+
+// Writes completed blocks to the sink. Runs on every monitor report window;
+// call it more often from a task if the buffers fill faster than that.
+void gpio_trace_flush(void);
+
+// Stops recording, writes out the partially filled block and releases the
+// traced pins' interrupts
+void gpio_trace_stop(void);
+
+// Returns the number of records dropped because both buffers were full
+uint32_t gpio_trace_dropped(void);
+
+#endif // GPIO_TRACE_H
@@ -0,0 +1,121 @@
+#include <string.h>
+#include "gpio_trace_reader.h"
+#include "gpio_trace.h"
+
+static uint32_t get_u32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Returns the position after the varint, or NULL if it runs past end
+static const uint8_t* get_varint(const uint8_t* p, const uint8_t* end, uint64_t* value) {
+    uint64_t v = 0;
+    unsigned shift = 0;
+
+    while (p < end && shift < 64) {
+        uint8_t byte = *p++;
+        v |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *value = v;
+            return p;
+        }
+        shift += 7;
+    }
+    return NULL;
+}
+
+int gpio_trace_read_header(const uint8_t* data, size_t len, gpio_trace_header_t* header, size_t* offset) {
+    uint16_t header_size;
+
+    if (len < GPIO_TRACE_HEADER_SIZE || memcmp(data, GPIO_TRACE_MAGIC, 4) != 0) {
+        return -1;
+    }
+    header->version = data[4];
+    header->width = data[5];
+    header_size = (uint16_t)(data[6] | (data[7] << 8));
+    header->mask = get_u32(data + 8);
+    header->clock_hz = get_u32(data + 12);
+
+    if (header->version != GPIO_TRACE_VERSION || header->width > sizeof(gpio_mask_t) * 8 ||
+        header_size < GPIO_TRACE_HEADER_SIZE || header_size > len) {
+        return -1;
+    }
+    *offset = header_size;
+    return 0;
+}
+
+int gpio_trace_read_block(const uint8_t* data, size_t len, size_t* offset, gpio_trace_block_t* block) {
+    const uint8_t* p = data + *offset;
+
+    if (*offset == len) {
+        return 0;
+    }
+    if (len - *offset < GPIO_TRACE_BLOCK_HEADER_SIZE) {
+        return -1;
+    }
+    block->payload_len = get_u32(p);
+    block->record_count = get_u32(p + 4);
+    block->base_timestamp = (uint64_t)get_u32(p + 8) | ((uint64_t)get_u32(p + 12) << 32);
+    block->base_state = get_u32(p + 16);
+    block->dropped = get_u32(p + 20);
+    if (block->payload_len > len - *offset - GPIO_TRACE_BLOCK_HEADER_SIZE) {
+        return -1;
+    }
+    block->payload = p + GPIO_TRACE_BLOCK_HEADER_SIZE;
+    *offset += GPIO_TRACE_BLOCK_HEADER_SIZE + block->payload_len;
+    return 1;
+}
+
+void gpio_trace_cursor_init(gpio_trace_cursor_t* cursor, const gpio_trace_block_t* block) {
+    cursor->pos = block->payload;
+    cursor->end = block->payload + block->payload_len;
+    cursor->remaining = block->record_count;
+    cursor->timestamp = block->base_timestamp;
+    cursor->state = block->base_state;
+}
+
+int gpio_trace_cursor_next(gpio_trace_cursor_t* cursor, gpio_trace_record_t* record) {
+    uint64_t delta;
+    uint64_t changed;
+    const uint8_t* p;
+
+    if (cursor->remaining == 0) {
+        return 0;
+    }
+    p = get_varint(cursor->pos, cursor->end, &delta);
+    if (p == NULL) {
+        return -1;
+    }
+    p = get_varint(p, cursor->end, &changed);
+    if (p == NULL || changed > (gpio_mask_t)~0u) {
+        return -1;
+    }
+    cursor->pos = p;
+    --cursor->remaining;
+    cursor->timestamp += delta;
+    cursor->state ^= (gpio_mask_t)changed;
+
+    record->timestamp = cursor->timestamp;
+    record->state = cursor->state;
+    record->changed = (gpio_mask_t)changed;
+    return 1;
+}
+
+int gpio_trace_reader_open(gpio_trace_reader_t* reader, const uint8_t* data, size_t len) {
+    reader->data = data;
+    reader->len = len;
+    reader->cursor.remaining = 0;
+    return gpio_trace_read_header(data, len, &reader->header, &reader->offset);
+}
+
+int gpio_trace_reader_next(gpio_trace_reader_t* reader, gpio_trace_record_t* record) {
+    int result;
+
+    while ((result = gpio_trace_cursor_next(&reader->cursor, record)) == 0) {
+        result = gpio_trace_read_block(reader->data, reader->len, &reader->offset, &reader->block);
+        if (result <= 0) {
+            return result;
+        }
+        gpio_trace_cursor_init(&reader->cursor, &reader->block);
+    }
+    return result;
+}
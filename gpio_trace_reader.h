@@ -0,0 +1,71 @@
+#ifndef GPIO_TRACE_READER_H
+#define GPIO_TRACE_READER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "gpio_hal.h"
+
+// Host-side decoder for traces written by gpio_trace.c. Works directly on the
+// trace bytes (a file read into memory or mapped), without copying them.
+
+typedef struct {
+    uint8_t version;
+    uint8_t width;        // Port width in bits
+    gpio_mask_t mask;     // Traced pins
+    uint32_t clock_hz;    // Timestamp clock rate
+} gpio_trace_header_t;
+
+typedef struct {
+    const uint8_t* payload;
+    uint32_t payload_len;
+    uint32_t record_count;
+    uint64_t base_timestamp;
+    gpio_mask_t base_state;
+    uint32_t dropped;     // Records lost just before this block
+} gpio_trace_block_t;
+
+typedef struct {
+    uint64_t timestamp;   // Ticks of clock_hz
+    gpio_mask_t state;    // Traced pin state after the change
+    gpio_mask_t changed;  // Pins that toggled
+} gpio_trace_record_t;
+
+// Decodes the records of one block
+typedef struct {
+    const uint8_t* pos;
+    const uint8_t* end;
+    uint32_t remaining;
+    uint64_t timestamp;
+    gpio_mask_t state;
+} gpio_trace_cursor_t;
+
+// Decodes a whole trace record by record
+typedef struct {
+    const uint8_t* data;
+    size_t len;
+    size_t offset;        // Offset of the next block
+    gpio_trace_header_t header;
+    gpio_trace_block_t block;
+    gpio_trace_cursor_t cursor;
+} gpio_trace_reader_t;
+
+// Parses the file header and sets *offset to the first block.
+// Returns 0 on success, -1 if the data is not a supported trace.
+int gpio_trace_read_header(const uint8_t* data, size_t len, gpio_trace_header_t* header, size_t* offset);
+
+// Parses the block at *offset and advances *offset past it.
+// Returns 1 if a block was read, 0 at the end of the trace, -1 if truncated.
+int gpio_trace_read_block(const uint8_t* data, size_t len, size_t* offset, gpio_trace_block_t* block);
+
+void gpio_trace_cursor_init(gpio_trace_cursor_t* cursor, const gpio_trace_block_t* block);
+
+// Returns 1 if a record was decoded, 0 at the end of the block, -1 if corrupt
+int gpio_trace_cursor_next(gpio_trace_cursor_t* cursor, gpio_trace_record_t* record);
+
+// Returns 0 on success, -1 if the data is not a supported trace
+int gpio_trace_reader_open(gpio_trace_reader_t* reader, const uint8_t* data, size_t len);
+
+// Returns 1 if a record was decoded, 0 at the end of the trace, -1 if corrupt
+int gpio_trace_reader_next(gpio_trace_reader_t* reader, gpio_trace_record_t* record);
+
+#endif // GPIO_TRACE_READER_H
@@ -0,0 +1,183 @@
+#include <stddef.h>
+#include "pattern_engine.h"
+#include "rtos_api.h"
+
+// Compiled tables: bit i stands for step i of the concatenated patterns
+static uint32_t rise_steps[32];       // Steps completed by a rising edge on the pin
+static uint32_t fall_steps[32];       // Steps completed by a falling edge on the pin
+static uint32_t first_steps = 0;      // First step of every pattern
+static uint32_t last_steps = 0;       // Last step of every pattern
+static uint32_t timed_steps = 0;      // Steps with a time limit
+static uint32_t within[PATTERN_ENGINE_MAX_STEPS];
+static uint32_t pattern_steps[PATTERN_ENGINE_MAX_PATTERNS];
+static unsigned patterns_compiled = 0;
+static gpio_mask_t pattern_pins = 0;   // Step pins watched for the compiled patterns
+
+// Matching state: bit i set once steps up to i of its pattern have matched
+static uint32_t matched = 0;
+static uint32_t matched_at[PATTERN_ENGINE_MAX_STEPS];
+
+static volatile uint32_t hits[PATTERN_ENGINE_MAX_PATTERNS];
+static pattern_report_t report_sink = NULL;
+
+static void pattern_engine_on_window(void);
+
+static const event_observer_t pattern_observer = {
+    pattern_engine_process,
+    pattern_engine_on_window,
+    NULL
+};
+
+static unsigned lowest_bit(uint32_t bits) {
+    unsigned bit = 0;
+
+    while (!(bits & 1u)) {
+        bits >>= 1;
+        ++bit;
+    }
+    return bit;
+}
+
+void pattern_engine_process(const event_change_t* change) {
+    gpio_mask_t rising = ~change->previous_state & change->new_state;
+    gpio_mask_t falling = change->previous_state & ~change->new_state;
+    gpio_mask_t changed = rising | falling;
+    uint32_t match = 0;
+    uint32_t advance;
+    uint32_t bits;
+    uint32_t done;
+    unsigned i;
+
+    // Steps satisfied by this change, one table lookup per changed pin
+    while (changed) {
+        i = lowest_bit(changed);
+        match |= (rising & (1u << i)) ? rise_steps[i] : fall_steps[i];
+        changed &= changed - 1;
+    }
+    if (!match) {
+        return;
+    }
+
+    // Every pattern advances by one step where its next step matches
+    advance = ((matched << 1) | first_steps) & match;
+
+    // Drop advances that came too late after the previous step
+    bits = advance & timed_steps;
+    while (bits) {
+        i = lowest_bit(bits);
+        if ((uint32_t)(change->timestamp - matched_at[i - 1]) > within[i]) {
+            advance &= ~(1u << i);
+        }
+        bits &= bits - 1;
+    }
+
+    bits = advance;
+    while (bits) {
+        matched_at[lowest_bit(bits)] = change->timestamp;
+        bits &= bits - 1;
+    }
+    matched |= advance;
+
+    done = matched & last_steps;
+    if (done) {
+        rtos_mutex_lock();
+        for (i = 0; i < patterns_compiled; ++i) {
+            if (done & pattern_steps[i]) {
+                ++hits[i];
+                // Start over once the whole sequence has been seen
+                matched &= ~pattern_steps[i];
+            }
+        }
+        rtos_mutex_unlock();
+    }
+}
+
+static void pattern_engine_on_window(void) {
+    uint32_t window_hits[PATTERN_ENGINE_MAX_PATTERNS];
+    unsigned i;
+
+    // Atomically read and reset the hit counters
+    rtos_mutex_lock();
+    for (i = 0; i < patterns_compiled; ++i) {
+        window_hits[i] = hits[i];
+        hits[i] = 0;
+    }
+    rtos_mutex_unlock();
+
+    if (report_sink) {
+        report_sink(window_hits, patterns_compiled);
+    }
+}
+
+int pattern_engine_init(const pattern_t* patterns, unsigned pattern_count, pattern_report_t sink) {
+    gpio_mask_t pins = 0;
+    unsigned step = 0;
+    unsigned p;
+    unsigned s;
+
+    if (pattern_count > PATTERN_ENGINE_MAX_PATTERNS) {
+        return -1;
+    }
+    for (p = 0; p < pattern_count; ++p) {
+        if (patterns[p].step_count == 0) {
+            return -1;
+        }
+        for (s = 0; s < patterns[p].step_count; ++s) {
+            if (patterns[p].steps[s].pin >= 32) {
+                return -1;
+            }
+            pins |= 1u << patterns[p].steps[s].pin;
+        }
+        step += patterns[p].step_count;
+    }
+    if (step > PATTERN_ENGINE_MAX_STEPS) {
+        return -1;
+    }
+
+    event_monitor_remove_observer(&pattern_observer);
+    // The previous patterns' pins no longer need interrupts
+    event_monitor_unwatch_pins(pattern_pins);
+    pattern_pins = 0;
+
+    for (s = 0; s < 32; ++s) {
+        rise_steps[s] = 0;
+        fall_steps[s] = 0;
+    }
+    first_steps = 0;
+    last_steps = 0;
+    timed_steps = 0;
+    matched = 0;
+
+    step = 0;
+    for (p = 0; p < pattern_count; ++p) {
+        pattern_steps[p] = 0;
+        first_steps |= 1u << step;
+        for (s = 0; s < patterns[p].step_count; ++s, ++step) {
+            const pattern_step_t* def = &patterns[p].steps[s];
+            uint32_t bit = 1u << step;
+            if (def->edge != PATTERN_FALL) {
+                rise_steps[def->pin] |= bit;
+            }
+            if (def->edge != PATTERN_RISE) {
+                fall_steps[def->pin] |= bit;
+            }
+            // A first step has no predecessor to be timed against
+            within[step] = def->within;
+            if (s > 0 && def->within) {
+                timed_steps |= bit;
+            }
+            pattern_steps[p] |= bit;
+        }
+        last_steps |= 1u << (step - 1);
+        hits[p] = 0;
+    }
+    patterns_compiled = pattern_count;
+    report_sink = sink;
+
+    if (event_monitor_add_observer(&pattern_observer) != 0) {
+        return -1;
+    }
+    pattern_pins = pins;
+    event_monitor_watch_pins(pins);
+    return 0;
+}
@@ -0,0 +1,48 @@
+#ifndef PATTERN_ENGINE_H
+#define PATTERN_ENGINE_H
+
+#include <stdint.h>
+#include "event_monitor.h"
+#include "gpio_hal.h"
+
+// Multi-pin edge sequence matching, e.g. "pin 3 rises, then pin 5 rises
+// within 2 ms, then pin 3 falls". Patterns are compiled into per-pin bitmask
+// tables with one bit per pattern step, so every pattern advances in the same
+// few mask operations per change (shift-and matching, as in Bitap). Other
+// changes may occur between the steps of a pattern.
+
+// Total steps over all patterns, one bit each
+#define PATTERN_ENGINE_MAX_STEPS 32
+#define PATTERN_ENGINE_MAX_PATTERNS 8
+
+typedef enum {
+    PATTERN_RISE,
+    PATTERN_FALL,
+    PATTERN_EITHER
+} pattern_edge_t;
+
+typedef struct {
+    uint8_t pin;
+    pattern_edge_t edge;
+    uint32_t within;          // Max ticks since the previous step, 0 for no limit
+} pattern_step_t;
+
+typedef struct {
+    const pattern_step_t* steps;
+    uint8_t step_count;
+} pattern_t;
+
+// Receives the hits of each pattern over the last report window
+typedef void (*pattern_report_t)(const uint32_t* hits, unsigned pattern_count);
+
+// Compiles the patterns and hooks the engine into the monitor; the sink is
+// called after each report_event_count(). Replaces the pins watched for a
+// previous configuration. Returns 0 on success, -1 if the patterns do not fit
+// the tables or the observer table is full.
+int pattern_engine_init(const pattern_t* patterns, unsigned pattern_count, pattern_report_t sink);
+
+// Advances all patterns on one change. Runs from the monitor callback; a
+// platform with its own deferred-work context may call it from there instead.
+void pattern_engine_process(const event_change_t* change);
+
+#endif // PATTERN_ENGINE_H
@@ -0,0 +1,82 @@
+#ifndef PIN_BITS_H
+#define PIN_BITS_H
+
+#include <stdint.h>
+#include "gpio_hal.h"
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+// Bit helpers shared by the counting modules: popcount, rank of a pin in a
+// mask, and dense per-pin counters indexed by rank.
+
+// Keeps the compiler from moving memory accesses across a sequence counter
+// update, for lock-free readers
+#if defined(__GNUC__)
+#define PIN_BITS_BARRIER() __asm__ __volatile__("" ::: "memory")
+#else
+#define PIN_BITS_BARRIER()
+#endif
+
+// Counts the set bits of a mask
+static inline unsigned pin_bits_count(gpio_mask_t bits) {
+#if defined(__GNUC__)
+    return (unsigned)__builtin_popcount(bits);
+#else
+    bits = bits - ((bits >> 1) & 0x55555555u);
+    bits = (bits & 0x33333333u) + ((bits >> 2) & 0x33333333u);
+    bits = (bits + (bits >> 4)) & 0x0F0F0F0Fu;
+    return (unsigned)((bits * 0x01010101u) >> 24);
+#endif
+}
+
+// Number of pins in mask below pin, i.e. its dense counter index
+static inline unsigned pin_bits_rank(gpio_mask_t mask, unsigned pin) {
+    return pin_bits_count(mask & ((1u << pin) - 1u));
+}
+
+// Adds one to the dense counter of every pin in edges, a subset of mask;
+// counts[i] belongs to the i-th lowest pin of mask. Builds with __BMI2__
+// gather the edges into counter order with PEXT.
+static inline void pin_bits_count_ranked(volatile uint32_t* counts, gpio_mask_t mask, gpio_mask_t edges) {
+#if defined(__BMI2__)
+    uint32_t dense = _pext_u32(edges, mask);
+    while (dense) {
+        ++counts[__builtin_ctz(dense)];
+        dense &= dense - 1;
+    }
+#else
+    while (edges) {
+        gpio_mask_t lowest = edges & (0u - edges);
+        ++counts[pin_bits_count(mask & (lowest - 1u))];
+        edges &= edges - 1;
+    }
+#endif
+}
+
+// Spreads dense counters back out to one entry per pin; pins not in mask get 0
+static inline void pin_bits_expand(uint32_t* by_pin, const volatile uint32_t* counts, gpio_mask_t mask) {
+    unsigned rank = 0;
+    unsigned pin;
+
+    for (pin = 0; pin < 32; ++pin) {
+        by_pin[pin] = ((mask >> pin) & 1u) ? counts[rank++] : 0;
+    }
+}
+
+// Packs the entries of the pins in mask into dense counters, the inverse of
+// pin_bits_expand(); returns the number of pins
+static inline unsigned pin_bits_gather(uint32_t* counts, const uint32_t* by_pin, gpio_mask_t mask) {
+    unsigned rank = 0;
+    unsigned pin;
+
+    for (pin = 0; pin < 32; ++pin) {
+        if ((mask >> pin) & 1u) {
+            counts[rank++] = by_pin[pin];
+        }
+    }
+    return rank;
+}
+
+#endif // PIN_BITS_H
@@ -0,0 +1,41 @@
+#include <stddef.h>
+#include "pin_counters.h"
+#include "event_monitor.h"
+#include "pin_bits.h"
+
+static gpio_mask_t counted_pins = 0;
+static unsigned counter_count = 0;
+static pin_counters_report_t report_sink = NULL;
+
+unsigned pin_counters_index(gpio_mask_t mask, unsigned pin) {
+    return pin_bits_rank(mask, pin);
+}
+
+// The monitor's report carries the window's per-pin counts; no counting of our own
+static void pin_counters_report(const event_report_t* report) {
+    uint32_t window_counts[PIN_COUNTERS_CAPACITY];
+
+    pin_bits_gather(window_counts, report->pin_counts, counted_pins);
+    event_monitor_release_report(report);
+
+    if (report_sink) {
+        report_sink(window_counts, counted_pins, counter_count);
+    }
+}
+
+int pin_counters_init(gpio_mask_t mask, pin_counters_report_t sink) {
+    unsigned count = pin_bits_count(mask);
+
+    if (count > PIN_COUNTERS_CAPACITY) {
+        return -1;
+    }
+
+    event_monitor_remove_report_sink(pin_counters_report);
+
+    counted_pins = mask;
+    counter_count = count;
+    report_sink = sink;
+
+    event_monitor_count_pins(1);
+    return event_monitor_add_report_sink(pin_counters_report);
+}
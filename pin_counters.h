@@ -0,0 +1,32 @@
+#ifndef PIN_COUNTERS_H
+#define PIN_COUNTERS_H
+
+#include <stdint.h>
+#include "gpio_hal.h"
+
+// Per-pin rising-edge counts reported densely: one counter per counted pin,
+// in pin order. A pin's counter index is the number of counted pins below it
+// (its rank in the mask). The counts are taken from the monitor's report, whose
+// per-pin counters are dense by rank in the monitored mask (builds with
+// __BMI2__ get all indices of an edge mask at once from PEXT), so the callback
+// keeps one set of counters however many modules read them.
+
+// Counted pins at most, i.e. the size of the dense counter array
+#ifndef PIN_COUNTERS_CAPACITY
+#define PIN_COUNTERS_CAPACITY 8
+#endif
+
+// Receives the counts of the last report window; counts[i] belongs to the
+// i-th lowest pin set in pins
+typedef void (*pin_counters_report_t)(const uint32_t* counts, gpio_mask_t pins, unsigned count);
+
+// Starts reporting rising edges on the pins in mask (monitored pins only are
+// seen) and enables the monitor's per-pin counting. The sink is called after
+// each report_event_count(). Returns 0 on success, -1 if mask has more than
+// PIN_COUNTERS_CAPACITY pins or the report sink table is full.
+int pin_counters_init(gpio_mask_t mask, pin_counters_report_t sink);
+
+// Dense counter index of a counted pin
+unsigned pin_counters_index(gpio_mask_t mask, unsigned pin);
+
+#endif // PIN_COUNTERS_H
@@ -0,0 +1,105 @@
+#include <stddef.h>
+#include "pin_groups.h"
+#include "event_monitor.h"
+#include "pin_bits.h"
+#include "rtos_api.h"
+
+#if defined(__GNUC__) && !defined(PIN_GROUPS_NO_VECTOR)
+#define PIN_GROUPS_VECTOR 1
+typedef uint32_t group_lanes_t __attribute__((vector_size(16)));
+#endif
+
+// Four groups side by side, one per lane
+typedef union {
+    uint32_t lane[4];
+#ifdef PIN_GROUPS_VECTOR
+    group_lanes_t v;
+#endif
+} group_quad_t;
+
+static group_quad_t masks[PIN_GROUPS_MAX / 4];
+static group_quad_t counts[PIN_GROUPS_MAX / 4];
+static unsigned quads = 0;
+static unsigned groups = 0;
+static pin_groups_report_t report_sink = NULL;
+
+static void pin_groups_on_change(const event_change_t* change);
+static void pin_groups_on_window(void);
+
+static const event_observer_t pin_groups_observer = {
+    pin_groups_on_change,
+    pin_groups_on_window,
+    NULL
+};
+
+#ifdef PIN_GROUPS_VECTOR
+// Bit-slice popcount of each lane
+static group_lanes_t count_lanes(group_lanes_t bits) {
+    bits = bits - ((bits >> 1) & 0x55555555u);
+    bits = (bits & 0x33333333u) + ((bits >> 2) & 0x33333333u);
+    bits = (bits + (bits >> 4)) & 0x0F0F0F0Fu;
+    return (bits * 0x01010101u) >> 24;
+}
+#endif
+
+static void pin_groups_on_change(const event_change_t* change) {
+    gpio_mask_t rising = change->rising_edges;
+    unsigned q;
+
+    if (!rising) {
+        return;
+    }
+
+    rtos_mutex_lock();
+    for (q = 0; q < quads; ++q) {
+#ifdef PIN_GROUPS_VECTOR
+        counts[q].v += count_lanes(masks[q].v & rising);
+#else
+        unsigned lane;
+        for (lane = 0; lane < 4; ++lane) {
+            counts[q].lane[lane] += pin_bits_count(masks[q].lane[lane] & rising);
+        }
+#endif
+    }
+    rtos_mutex_unlock();
+}
+
+static void pin_groups_on_window(void) {
+    uint32_t window_counts[PIN_GROUPS_MAX];
+    unsigned g;
+
+    // Atomically read and reset the counters
+    rtos_mutex_lock();
+    for (g = 0; g < groups; ++g) {
+        window_counts[g] = counts[g / 4].lane[g % 4];
+        counts[g / 4].lane[g % 4] = 0;
+    }
+    rtos_mutex_unlock();
+
+    if (report_sink) {
+        report_sink(window_counts, groups);
+    }
+}
+
+int pin_groups_init(const gpio_mask_t* group_masks, unsigned group_count, pin_groups_report_t sink) {
+    unsigned g;
+
+    if (group_count > PIN_GROUPS_MAX) {
+        return -1;
+    }
+
+    event_monitor_remove_observer(&pin_groups_observer);
+
+    rtos_mutex_lock();
+    // Unused lanes keep a zero mask and never count
+    for (g = 0; g < PIN_GROUPS_MAX; ++g) {
+        masks[g / 4].lane[g % 4] = g < group_count ? group_masks[g] : 0;
+        counts[g / 4].lane[g % 4] = 0;
+    }
+    groups = group_count;
+    quads = (group_count + 3) / 4;
+    report_sink = sink;
+    rtos_mutex_unlock();
+
+    return event_monitor_add_observer(&pin_groups_observer);
+}
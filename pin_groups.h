@@ -0,0 +1,30 @@
+#ifndef PIN_GROUPS_H
+#define PIN_GROUPS_H
+
+#include <stdint.h>
+#include "gpio_hal.h"
+
+// Rising-edge totals per logical pin group ("door sensors", "flow meters"),
+// all on one monitor. Each change adds popcount(rising_edges & group_mask[g])
+// to every group in one pass; GCC-compatible builds process four groups per
+// step with vector extensions (disable with -DPIN_GROUPS_NO_VECTOR). Groups
+// may overlap. Only monitored pins are seen.
+
+// Groups at most; a multiple of 4
+#ifndef PIN_GROUPS_MAX
+#define PIN_GROUPS_MAX 16
+#endif
+
+#if PIN_GROUPS_MAX % 4 != 0
+#error "PIN_GROUPS_MAX must be a multiple of 4"
+#endif
+
+// Receives the counts of all groups for the last report window in one call
+typedef void (*pin_groups_report_t)(const uint32_t* counts, unsigned group_count);
+
+// Starts counting the given group masks. The sink is called after each
+// report_event_count(). Returns 0 on success, -1 if there are more than
+// PIN_GROUPS_MAX groups or the observer table is full.
+int pin_groups_init(const gpio_mask_t* group_masks, unsigned group_count, pin_groups_report_t sink);
+
+#endif // PIN_GROUPS_H
@@ -0,0 +1,136 @@
+#include <stddef.h>
+#include "quadrature.h"
+#include "rtos_api.h"
+
+#define QUADRATURE_INVALID 2
+#define NO_PAIR 0xFF
+
+// Indexed by (previous AB << 2) | new AB, with A as the high bit. The
+// Gray sequence 00 -> 01 -> 11 -> 10 counts up.
+static const int8_t transitions[16] = {
+     0, +1, -1, QUADRATURE_INVALID,
+    -1,  0, QUADRATURE_INVALID, +1,
+    +1, QUADRATURE_INVALID,  0, -1,
+    QUADRATURE_INVALID, -1, +1,  0
+};
+
+static quadrature_pair_t pair_pins[QUADRATURE_MAX_PAIRS];
+static uint8_t pin_pair[32];          // Pair index per pin, NO_PAIR if unused
+static gpio_mask_t encoder_pins = 0;
+static unsigned pairs_configured = 0;
+
+static volatile int32_t deltas[QUADRATURE_MAX_PAIRS];
+static volatile uint32_t errors[QUADRATURE_MAX_PAIRS];
+static quadrature_report_t report_sink = NULL;
+
+static void quadrature_on_change(const event_change_t* change);
+static void quadrature_on_window(void);
+
+static const event_observer_t quadrature_observer = {
+    quadrature_on_change,
+    quadrature_on_window,
+    NULL
+};
+
+static uint32_t pair_bits(gpio_mask_t state, const quadrature_pair_t* pair) {
+    return (((state >> pair->pin_a) & 1u) << 1) | ((state >> pair->pin_b) & 1u);
+}
+
+static void quadrature_on_change(const event_change_t* change) {
+    gpio_mask_t changed = (change->previous_state ^ change->new_state) & encoder_pins;
+    uint32_t touched = 0;
+    unsigned pin;
+    unsigned i;
+
+    if (!changed) {
+        return;
+    }
+
+    // One pass over the changed bits collects the pairs to decode
+    for (pin = 0; changed; ++pin, changed >>= 1) {
+        if (changed & 1u) {
+            touched |= 1u << pin_pair[pin];
+        }
+    }
+
+    rtos_mutex_lock();
+    for (i = 0; touched; ++i, touched >>= 1) {
+        if (touched & 1u) {
+            int8_t step = transitions[(pair_bits(change->previous_state, &pair_pins[i]) << 2) |
+                                      pair_bits(change->new_state, &pair_pins[i])];
+            if (step == QUADRATURE_INVALID) {
+                ++errors[i];
+            } else {
+                deltas[i] += step;
+            }
+        }
+    }
+    rtos_mutex_unlock();
+}
+
+static void quadrature_on_window(void) {
+    int32_t window_deltas[QUADRATURE_MAX_PAIRS];
+    uint32_t window_errors[QUADRATURE_MAX_PAIRS];
+    unsigned i;
+
+    // Atomically read and reset the per-pair counters
+    rtos_mutex_lock();
+    for (i = 0; i < pairs_configured; ++i) {
+        window_deltas[i] = deltas[i];
+        window_errors[i] = errors[i];
+        deltas[i] = 0;
+        errors[i] = 0;
+    }
+    rtos_mutex_unlock();
+
+    if (report_sink) {
+        report_sink(window_deltas, window_errors, pairs_configured);
+    }
+}
+
+int quadrature_init(const quadrature_pair_t* pairs, unsigned pair_count, quadrature_report_t sink) {
+    gpio_mask_t pins = 0;
+    unsigned i;
+
+    if (pair_count > QUADRATURE_MAX_PAIRS) {
+        return -1;
+    }
+    for (i = 0; i < pair_count; ++i) {
+        gpio_mask_t a;
+        gpio_mask_t b;
+        if (pairs[i].pin_a >= 32 || pairs[i].pin_b >= 32) {
+            return -1;
+        }
+        a = 1u << pairs[i].pin_a;
+        b = 1u << pairs[i].pin_b;
+        if ((pins & (a | b)) || a == b) {
+            return -1;
+        }
+        pins |= a | b;
+    }
+
+    event_monitor_remove_observer(&quadrature_observer);
+    // The previous pairs' pins no longer need interrupts
+    event_monitor_unwatch_pins(encoder_pins);
+    encoder_pins = 0;
+
+    for (i = 0; i < 32; ++i) {
+        pin_pair[i] = NO_PAIR;
+    }
+    for (i = 0; i < pair_count; ++i) {
+        pair_pins[i] = pairs[i];
+        pin_pair[pairs[i].pin_a] = (uint8_t)i;
+        pin_pair[pairs[i].pin_b] = (uint8_t)i;
+        deltas[i] = 0;
+        errors[i] = 0;
+    }
+    pairs_configured = pair_count;
+    report_sink = sink;
+
+    if (event_monitor_add_observer(&quadrature_observer) != 0) {
+        return -1;
+    }
+    encoder_pins = pins;
+    event_monitor_watch_pins(pins);
+    return 0;
+}
@@ -0,0 +1,29 @@
+#ifndef QUADRATURE_H
+#define QUADRATURE_H
+
+#include <stdint.h>
+#include "event_monitor.h"
+#include "gpio_hal.h"
+
+// Quadrature decoding of A/B encoder channels at 4x resolution. Each pair is
+// decoded through a 16-entry table indexed by its previous and new A/B bits;
+// a change of both channels at once cannot be decoded and counts as an error.
+
+#define QUADRATURE_MAX_PAIRS 8
+
+typedef struct {
+    uint8_t pin_a;
+    uint8_t pin_b;
+} quadrature_pair_t;
+
+// Receives the signed position change and error count of each pair over the
+// last report window
+typedef void (*quadrature_report_t)(const int32_t* deltas, const uint32_t* errors, unsigned pair_count);
+
+// Hooks the decoder into the monitor; the sink is called after each
+// report_event_count(). Replaces the pins watched for a previous
+// configuration. Returns 0 on success, -1 if a pin is out of range or used
+// twice, or if the observer table is full.
+int quadrature_init(const quadrature_pair_t* pairs, unsigned pair_count, quadrature_report_t sink);
+
+#endif // QUADRATURE_H
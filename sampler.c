@@ -0,0 +1,95 @@
+#include <stddef.h>
+#include "sampler.h"
+#include "event_monitor.h"
+#include "rtos_api.h"
+
+static uint32_t sample_rate = 0;
+static volatile uint32_t task_period_ms = 0;  // 0 when the task is not the source
+static sampler_report_t report_sink = NULL;
+static volatile uint32_t window_samples = 0;
+
+static void sampler_on_window(void);
+
+static const event_observer_t sampler_observer = {
+    NULL,
+    sampler_on_window,
+    NULL
+};
+
+void sampler_tick(void) {
+    event_monitor_sample(gpio_read_input());
+
+    rtos_mutex_lock();
+    ++window_samples;
+    rtos_mutex_unlock();
+}
+
+void sampler_drain(const gpio_mask_t* samples, uint32_t count) {
+    event_monitor_process_batch(samples, NULL, count);
+
+    rtos_mutex_lock();
+    window_samples += count;
+    rtos_mutex_unlock();
+}
+
+uint32_t sampler_min_pulse_ns(void) {
+    if (sample_rate == 0) {
+        return 0;
+    }
+    return (uint32_t)((1000000000ull + sample_rate - 1) / sample_rate);
+}
+
+static void sampler_on_window(void) {
+    uint32_t samples;
+
+    rtos_mutex_lock();
+    samples = window_samples;
+    window_samples = 0;
+    rtos_mutex_unlock();
+
+    if (report_sink) {
+        report_sink(samples, sampler_min_pulse_ns());
+    }
+}
+
+static void sampler_task(void* arg) {
+    (void)arg; // Suppress unused parameter warning
+
+    while (1) {
+        uint32_t period = task_period_ms;
+
+        // Idles if a later sampler_init() chose another source
+        rtos_task_delay_ms(period ? period : 1000);
+
+        if (period) {
+            sampler_tick();
+        }
+    }
+}
+
+int sampler_init(uint32_t rate_hz, sampler_source_t source, sampler_report_t sink) {
+    static rtos_task_t task;
+    static int task_created = 0;
+
+    if (rate_hz == 0 || (source == SAMPLER_TASK && (rate_hz > 1000 || 1000 % rate_hz != 0))) {
+        return -1;
+    }
+
+    event_monitor_remove_observer(&sampler_observer);
+
+    rtos_mutex_lock();
+    sample_rate = rate_hz;
+    report_sink = sink;
+    window_samples = 0;
+    rtos_mutex_unlock();
+
+    task_period_ms = (source == SAMPLER_TASK) ? 1000 / rate_hz : 0;
+    if (source == SAMPLER_TASK) {
+        if (!task_created) {
+            rtos_task_create(&task, sampler_task, NULL);
+            task_created = 1;
+        }
+    }
+
+    return event_monitor_add_observer(&sampler_observer);
+}
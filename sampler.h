@@ -0,0 +1,39 @@
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include <stdint.h>
+#include "gpio_hal.h"
+
+// Sampling engine for boards without pin-change interrupts. The port is read
+// at a fixed rate and every sample goes through the monitor's edge detection
+// and counting, so observers and reports work as with interrupts. A pulse is
+// only guaranteed to be seen if it lasts at least one sample period, and two
+// pulses are only told apart if the gap between them does too.
+
+typedef enum {
+    SAMPLER_TASK,   // An RTOS task samples; rate_hz must divide 1000
+    SAMPLER_TIMER,  // The platform calls sampler_tick() from a timer at rate_hz
+    SAMPLER_DMA     // The platform passes DMA-filled buffers to sampler_drain()
+} sampler_source_t;
+
+// Receives the samples taken over the last report window and the minimum
+// detectable pulse width in nanoseconds
+typedef void (*sampler_report_t)(uint32_t samples, uint32_t min_pulse_ns);
+
+// Hooks the sampler into the monitor, creating the sampling task for
+// SAMPLER_TASK. event_monitor_init() must have been called first. The sink
+// is called after each report_event_count(). Returns 0 on success, -1 on an
+// invalid rate or a full observer table.
+int sampler_init(uint32_t rate_hz, sampler_source_t source, sampler_report_t sink);
+
+// Takes one sample of gpio_read_input(); safe from a timer interrupt
+void sampler_tick(void);
+
+// Counts a buffer of consecutive samples taken at the configured rate through
+// event_monitor_process_batch(). Call from task context, and not alongside sampler_tick().
+void sampler_drain(const gpio_mask_t* samples, uint32_t count);
+
+// Shortest pulse guaranteed to be seen at the configured rate, rounded up
+uint32_t sampler_min_pulse_ns(void);
+
+#endif // SAMPLER_H
@@ -0,0 +1,164 @@
+#include <stddef.h>
+#include "storm_guard.h"
+#include "event_monitor.h"
+#include "rtos_api.h"
+
+static uint32_t storm_threshold = 0;
+static uint32_t slice_length = 0;
+static uint32_t poll_period_ms = 0;
+static storm_report_t report_sink = NULL;
+
+// Storm state, shared between the callback and the poll task under the lock
+static uint32_t slice_start = 0;
+static uint32_t slice_changes[32];
+static uint32_t backoff[32];          // Polls to stay masked after the next storm
+static uint32_t hold[32];             // Polls left until the pin is re-enabled
+static volatile gpio_mask_t polled_pins = 0;
+static gpio_mask_t window_polled = 0;   // Pins polled at any point in the window
+static uint32_t window_storms = 0;
+
+static void storm_guard_on_change(const event_change_t* change);
+static void storm_guard_on_window(void);
+
+static const event_observer_t storm_observer = {
+    storm_guard_on_change,
+    storm_guard_on_window,
+    NULL
+};
+
+static void storm_guard_on_change(const event_change_t* change) {
+    gpio_mask_t changed;
+    gpio_mask_t stormed = 0;
+    uint32_t pin;
+
+    rtos_mutex_lock();
+    // Polled pins are already rate limited by the poll period
+    changed = (change->previous_state ^ change->new_state) & ~polled_pins;
+    if (changed) {
+        if ((uint32_t)(change->timestamp - slice_start) >= slice_length) {
+            slice_start = change->timestamp;
+            for (pin = 0; pin < 32; ++pin) {
+                slice_changes[pin] = 0;
+            }
+        }
+        for (pin = 0; changed; ++pin, changed >>= 1) {
+            if ((changed & 1u) && ++slice_changes[pin] > storm_threshold) {
+                stormed |= 1u << pin;
+                hold[pin] = backoff[pin];
+                ++window_storms;
+            }
+        }
+        polled_pins |= stormed;
+        window_polled |= stormed;
+    }
+    rtos_mutex_unlock();
+
+    if (stormed) {
+        event_monitor_mask_interrupts_from(&polled_pins);
+    }
+}
+
+void storm_guard_poll(void) {
+    gpio_mask_t released = 0;
+    gpio_mask_t pins;
+    uint32_t pin;
+
+    rtos_mutex_lock();
+    pins = polled_pins;
+    rtos_mutex_unlock();
+
+    if (!pins) {
+        return;
+    }
+
+    event_monitor_sample(gpio_read_input());
+
+    rtos_mutex_lock();
+    for (pin = 0; pins; ++pin, pins >>= 1) {
+        if ((pins & 1u) && --hold[pin] == 0) {
+            released |= 1u << pin;
+            slice_changes[pin] = 0;
+            // Back off further if the pin storms again
+            backoff[pin] = backoff[pin] * 2 > STORM_GUARD_MAX_BACKOFF ? STORM_GUARD_MAX_BACKOFF : backoff[pin] * 2;
+        }
+    }
+    polled_pins &= ~released;
+    rtos_mutex_unlock();
+
+    if (released) {
+        // The callback may have masked another pin since; program the set as it is now
+        event_monitor_mask_interrupts_from(&polled_pins);
+    }
+}
+
+static void storm_guard_on_window(void) {
+    gpio_mask_t polled;
+    uint32_t storms;
+    uint32_t pin;
+
+    rtos_mutex_lock();
+    polled = polled_pins;
+    storms = window_storms;
+    // Pins that stayed quiet for a whole window start over at the minimum
+    // backoff; one released during the window was not quiet
+    for (pin = 0; pin < 32; ++pin) {
+        if (!(window_polled & (1u << pin))) {
+            backoff[pin] = STORM_GUARD_MIN_BACKOFF;
+        }
+    }
+    // Pins still polled carry over into the next window
+    window_polled = polled;
+    window_storms = 0;
+    rtos_mutex_unlock();
+
+    if (report_sink) {
+        report_sink(polled, storms);
+    }
+}
+
+static void poll_task(void* arg) {
+    (void)arg; // Suppress unused parameter warning
+
+    while (1) {
+        rtos_task_delay_ms(poll_period_ms);
+
+        storm_guard_poll();
+    }
+}
+
+int storm_guard_init(uint32_t max_changes, uint32_t slice_ticks, uint32_t poll_ms, storm_report_t sink) {
+    static rtos_task_t task;
+    static int task_created = 0;
+    uint32_t pin;
+
+    if (slice_ticks == 0 || poll_ms == 0) {
+        return -1;
+    }
+
+    event_monitor_remove_observer(&storm_observer);
+
+    rtos_mutex_lock();
+    storm_threshold = max_changes;
+    slice_length = slice_ticks;
+    poll_period_ms = poll_ms;
+    report_sink = sink;
+    for (pin = 0; pin < 32; ++pin) {
+        slice_changes[pin] = 0;
+        backoff[pin] = STORM_GUARD_MIN_BACKOFF;
+        hold[pin] = 0;
+    }
+    polled_pins = 0;
+    window_polled = 0;
+    window_storms = 0;
+    rtos_mutex_unlock();
+
+    event_monitor_mask_interrupts_from(&polled_pins);
+
+    // The task idles while no pin is masked
+    if (!task_created) {
+        rtos_task_create(&task, poll_task, NULL);
+        task_created = 1;
+    }
+
+    return event_monitor_add_observer(&storm_observer);
+}
@@ -0,0 +1,39 @@
+#ifndef STORM_GUARD_H
+#define STORM_GUARD_H
+
+#include <stdint.h>
+#include "gpio_hal.h"
+
+// Interrupt storm protection. A pin that changes more than max_changes times
+// within one time slice has its change interrupt masked and is sampled by a
+// poll task instead, which still counts its edges approximately (pulses
+// shorter than the poll period are missed). The pin is re-enabled after a
+// backoff that doubles each time it storms again and resets after a quiet
+// report window.
+
+// Polls a pin stays masked after its first storm
+#ifndef STORM_GUARD_MIN_BACKOFF
+#define STORM_GUARD_MIN_BACKOFF 8
+#endif
+
+// Upper limit for the doubled backoff, in polls
+#ifndef STORM_GUARD_MAX_BACKOFF
+#define STORM_GUARD_MAX_BACKOFF 1024
+#endif
+
+// Receives the pins being polled at the end of a report window and the number
+// of storms detected during it
+typedef void (*storm_report_t)(gpio_mask_t polled_pins, uint32_t storms);
+
+// Hooks the guard into the monitor and creates its poll task, which samples
+// every poll_ms while any pin is masked. slice_ticks is in gpio_read_timestamp()
+// units. The sink is called after each report_event_count(). Returns 0 on
+// success, -1 on invalid parameters or a full observer table.
+int storm_guard_init(uint32_t max_changes, uint32_t slice_ticks, uint32_t poll_ms, storm_report_t sink);
+
+// One poll step: samples the port if any pin is masked and re-enables pins
+// whose backoff has expired. The poll task calls this every poll_ms; hosts
+// that drive time themselves (tests) may call it directly.
+void storm_guard_poll(void);
+
+#endif // STORM_GUARD_H
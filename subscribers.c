@@ -0,0 +1,185 @@
+#include <stddef.h>
+#include "subscribers.h"
+#include "event_monitor.h"
+#include "pin_bits.h"
+#include "rtos_api.h"
+
+#define NO_SUBSCRIBER (-1)
+
+typedef struct {
+    gpio_mask_t mask;         // Zero for a free entry
+    uint32_t period_ticks;
+    uint32_t rounds;          // Wheel turns left before the subscriber is due
+    int next;                 // Next subscriber in the same wheel slot
+    subscriber_sink_t sink;
+} subscriber_t;
+
+static subscriber_t subscribers[SUBSCRIBERS_MAX];
+static volatile uint32_t counts[SUBSCRIBERS_MAX];
+static gpio_mask_t union_mask = 0;
+static int wheel[SUBSCRIBERS_WHEEL_SLOTS];
+static unsigned cursor = 0;
+static int registered = 0;
+
+static void subscribers_on_change(const event_change_t* change);
+static void subscribers_on_tick(void);
+
+static const event_observer_t subscribers_observer = {
+    subscribers_on_change,
+    NULL,
+    subscribers_on_tick
+};
+
+static void subscribers_on_change(const event_change_t* change) {
+    gpio_mask_t rising = ~change->previous_state & change->new_state & union_mask;
+    int i;
+
+    if (!rising) {
+        return;
+    }
+
+    rtos_mutex_lock();
+    for (i = 0; i < SUBSCRIBERS_MAX; ++i) {
+        if (subscribers[i].mask & rising) {
+            counts[i] += pin_bits_count(subscribers[i].mask & rising);
+        }
+    }
+    rtos_mutex_unlock();
+}
+
+// Files a subscriber period_ticks after the current slot; called under the lock
+static void schedule(int id) {
+    uint32_t ticks = subscribers[id].period_ticks;
+    unsigned slot = (cursor + ticks) & (SUBSCRIBERS_WHEEL_SLOTS - 1);
+
+    // A period of exactly one turn lands back on the current slot
+    subscribers[id].rounds = (ticks - 1) / SUBSCRIBERS_WHEEL_SLOTS;
+    subscribers[id].next = wheel[slot];
+    wheel[slot] = id;
+}
+
+static void subscribers_on_tick(void) {
+    int due[SUBSCRIBERS_MAX];
+    uint32_t due_counts[SUBSCRIBERS_MAX];
+    subscriber_sink_t sinks[SUBSCRIBERS_MAX];
+    int due_count = 0;
+    int id;
+    int next;
+    int i;
+
+    rtos_mutex_lock();
+    cursor = (cursor + 1) & (SUBSCRIBERS_WHEEL_SLOTS - 1);
+    // Detach the slot so rescheduled subscribers are not seen twice
+    id = wheel[cursor];
+    wheel[cursor] = NO_SUBSCRIBER;
+    for (; id != NO_SUBSCRIBER; id = next) {
+        next = subscribers[id].next;
+        if (subscribers[id].rounds) {
+            --subscribers[id].rounds;
+            subscribers[id].next = wheel[cursor];
+            wheel[cursor] = id;
+            continue;
+        }
+        // Atomically read and reset the count
+        due[due_count] = id;
+        due_counts[due_count] = counts[id];
+        sinks[due_count] = subscribers[id].sink;
+        ++due_count;
+        counts[id] = 0;
+        schedule(id);
+    }
+    rtos_mutex_unlock();
+
+    // Sinks run outside the lock
+    for (i = 0; i < due_count; ++i) {
+        if (sinks[i]) {
+            sinks[i](due[i], due_counts[i]);
+        }
+    }
+}
+
+static void update_union_mask(void) {
+    int i;
+
+    union_mask = 0;
+    for (i = 0; i < SUBSCRIBERS_MAX; ++i) {
+        union_mask |= subscribers[i].mask;
+    }
+}
+
+int subscriber_add(gpio_mask_t mask, uint32_t period_ms, subscriber_sink_t sink) {
+    int id;
+    int i;
+
+    if (mask == 0 || period_ms == 0 || period_ms % EVENT_MONITOR_TICK_MS != 0) {
+        return -1;
+    }
+
+    if (!registered) {
+        for (i = 0; i < SUBSCRIBERS_WHEEL_SLOTS; ++i) {
+            wheel[i] = NO_SUBSCRIBER;
+        }
+        if (event_monitor_add_observer(&subscribers_observer) != 0) {
+            return -1;
+        }
+        registered = 1;
+    }
+
+    rtos_mutex_lock();
+    for (id = 0; id < SUBSCRIBERS_MAX; ++id) {
+        if (subscribers[id].mask == 0) {
+            break;
+        }
+    }
+    if (id < SUBSCRIBERS_MAX) {
+        subscribers[id].mask = mask;
+        subscribers[id].period_ticks = period_ms / EVENT_MONITOR_TICK_MS;
+        subscribers[id].sink = sink;
+        counts[id] = 0;
+        schedule(id);
+        update_union_mask();
+    } else {
+        id = -1;
+    }
+    rtos_mutex_unlock();
+
+    if (id >= 0) {
+        // Subscribed pins raise the callback even when they are not monitored
+        event_monitor_watch_pins(mask);
+    }
+    return id;
+}
+
+void subscriber_remove(int id) {
+    gpio_mask_t mask;
+    int* link;
+    unsigned slot;
+
+    if (id < 0 || id >= SUBSCRIBERS_MAX) {
+        return;
+    }
+
+    rtos_mutex_lock();
+    mask = subscribers[id].mask;
+    if (mask) {
+        // Unlink from whichever slot holds it
+        for (slot = 0; slot < SUBSCRIBERS_WHEEL_SLOTS; ++slot) {
+            for (link = &wheel[slot]; *link != NO_SUBSCRIBER; link = &subscribers[*link].next) {
+                if (*link == id) {
+                    *link = subscribers[id].next;
+                    break;
+                }
+            }
+        }
+        subscribers[id].mask = 0;
+        subscribers[id].sink = NULL;
+        counts[id] = 0;
+        update_union_mask();
+    }
+    rtos_mutex_unlock();
+
+    if (mask) {
+        // Pins no other subscriber or observer watches stop raising the callback
+        event_monitor_unwatch_pins(mask);
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef SUBSCRIBERS_H
+#define SUBSCRIBERS_H
+
+#include <stdint.h>
+#include "gpio_hal.h"
+
+// Independent consumers of rising-edge counts, each with its own pin mask,
+// report period and sink. The callback counts every subscriber in one pass,
+// skipping changes without a rising edge on the union of their masks, and
+// the monitor task reports them from a timer wheel advanced once per
+// EVENT_MONITOR_TICK_MS. Subscribed pins need not be monitored; gates only
+// apply to the aggregate count.
+
+// Subscribers at most
+#ifndef SUBSCRIBERS_MAX
+#define SUBSCRIBERS_MAX 8
+#endif
+
+// Timer wheel slots; a power of two. Periods longer than the wheel take
+// extra turns.
+#ifndef SUBSCRIBERS_WHEEL_SLOTS
+#define SUBSCRIBERS_WHEEL_SLOTS 16
+#endif
+
+#if SUBSCRIBERS_WHEEL_SLOTS & (SUBSCRIBERS_WHEEL_SLOTS - 1)
+#error "SUBSCRIBERS_WHEEL_SLOTS must be a power of two"
+#endif
+
+// Receives the rising edges a subscriber's pins saw in its last period
+typedef void (*subscriber_sink_t)(int id, uint32_t count);
+
+// Adds a subscriber counting rising edges on mask, reported to sink every
+// period_ms (a positive multiple of EVENT_MONITOR_TICK_MS). Returns the
+// subscriber id, or -1 on an invalid period or a full table.
+int subscriber_add(gpio_mask_t mask, uint32_t period_ms, subscriber_sink_t sink);
+
+// Stops a subscriber; its pending count is dropped
+void subscriber_remove(int id);
+
+#endif // SUBSCRIBERS_H
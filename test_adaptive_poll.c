@@ -0,0 +1,179 @@
+#include <stdio.h>
+#include "event_monitor.h"
+#include "adaptive_poll.h"
+#include "gpio_hal.h"
+#include "rtos_api.h"
+
+// Mock state and test tracking
+static gpio_mask_t simulated_state = 0;
+static uint32_t simulated_time = 0;
+static void (*static_callback)(gpio_mask_t new_state) = NULL;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Last values handed to the HAL and the report sinks
+static gpio_mask_t interrupt_mask = 0;
+static uint32_t reported_interrupt_ticks = 0;
+static uint32_t reported_polling_ticks = 0;
+static uint32_t reported_switches = 0;
+static uint32_t reported_events = 0;
+
+// Mocks for HAL functions
+gpio_mask_t gpio_read_input(void) {
+    return simulated_state;
+}
+
+void gpio_register_callback(void (*callback)(gpio_mask_t new_state)) {
+    static_callback = callback;
+}
+
+uint32_t gpio_read_timestamp(void) {
+    return simulated_time;
+}
+
+void gpio_set_interrupt_mask(gpio_mask_t mask) {
+    interrupt_mask = mask;
+}
+
+// Mocks for RTOS functions
+void rtos_mutex_lock(void) {}
+void rtos_mutex_unlock(void) {}
+void rtos_task_delay_ms(uint32_t ms) { (void)ms; }
+void rtos_task_create(rtos_task_t* task, void (*task_fn)(void*), void* arg) {
+    (void)task; (void)task_fn; (void)arg;
+}
+
+void report_event_count(uint32_t count) {
+    reported_events = count;
+}
+
+static void report_modes(uint32_t interrupt_ticks, uint32_t polling_ticks, uint32_t switches) {
+    reported_interrupt_ticks = interrupt_ticks;
+    reported_polling_ticks = polling_ticks;
+    reported_switches = switches;
+}
+
+// Helper function to simulate GPIO changes at a given time
+void simulate_gpio_change(uint32_t time, gpio_mask_t new_state) {
+    simulated_time = time;
+    simulated_state = new_state;
+    if (static_callback) {
+        static_callback(new_state);
+    }
+}
+
+void check_test_result(const char* test_name, uint32_t expected, uint32_t actual) {
+    printf("  %s: Expected %u, Actual %u -> ", test_name, expected, actual);
+    if (expected == actual) {
+        printf("PASS\n");
+        tests_passed++;
+    } else {
+        printf("FAIL\n");
+        tests_failed++;
+    }
+}
+
+// Changes the port without an interrupt, as a masked pin does
+static void set_masked_state(uint32_t time, gpio_mask_t new_state) {
+    simulated_time = time;
+    simulated_state = new_state;
+}
+
+static void tick_at(uint32_t time) {
+    simulated_time = time;
+    adaptive_poll_tick();
+}
+
+void test_switch_to_polling() {
+    uint32_t i;
+
+    printf("\n1. Testing the switch to polling...\n");
+
+    simulated_state = 0;
+    simulated_time = 0;
+    event_monitor_init(0x01);
+    check_test_result("Switcher started", 0, (uint32_t)adaptive_poll_init(3, 2, 1, report_modes));
+    check_test_result("Interrupts enabled", 0x01, interrupt_mask);
+
+    // Three changes per period stay in interrupt mode
+    for (i = 1; i <= 3; ++i) {
+        simulate_gpio_change(i, i & 1);
+    }
+    tick_at(100);
+    check_test_result("Still interrupt driven", ADAPTIVE_MODE_INTERRUPT, adaptive_poll_mode());
+
+    for (i = 1; i <= 4; ++i) {
+        simulate_gpio_change(100 + i, (i & 1) ^ 1);
+    }
+    tick_at(200);
+    check_test_result("Switched to polling", ADAPTIVE_MODE_POLLING, adaptive_poll_mode());
+    check_test_result("All interrupts masked", 0, interrupt_mask);
+}
+
+void test_polling_and_back() {
+    printf("\n2. Testing polled counting and the switch back...\n");
+
+    set_masked_state(250, 0x00);
+    tick_at(300);
+    set_masked_state(350, 0x01);
+    tick_at(400);
+    set_masked_state(450, 0x00);
+    tick_at(500);
+    check_test_result("Busy port keeps polling", ADAPTIVE_MODE_POLLING, adaptive_poll_mode());
+
+    // A pulse between two polls is missed
+    set_masked_state(510, 0x01);
+    set_masked_state(520, 0x00);
+    set_masked_state(550, 0x01);
+    tick_at(600);
+    tick_at(700);
+    check_test_result("One idle poll keeps polling", ADAPTIVE_MODE_POLLING, adaptive_poll_mode());
+    tick_at(800);
+    check_test_result("Idle port switches back", ADAPTIVE_MODE_INTERRUPT, adaptive_poll_mode());
+    check_test_result("Interrupts enabled again", 0x01, interrupt_mask);
+
+    simulate_gpio_change(900, 0x00);
+    simulate_gpio_change(950, 0x01);
+    simulated_time = 1000;
+
+    // Rises: 2 + 2 on interrupts, 2 polled, 1 on interrupts again
+    event_monitor_report_window();
+    check_test_result("Every seen rise counted once", 7, reported_events);
+    check_test_result("Interrupt time", 200 + 200, reported_interrupt_ticks);
+    check_test_result("Polling time", 600, reported_polling_ticks);
+    check_test_result("Two switches", 2, reported_switches);
+
+    simulated_time = 1500;
+    event_monitor_report_window();
+    check_test_result("Next window all interrupt", 500, reported_interrupt_ticks);
+    check_test_result("No polling time", 0, reported_polling_ticks);
+}
+
+void print_test_summary() {
+    int total_tests = tests_passed + tests_failed;
+
+    printf("\n----------------------------------------\n");
+    printf("TEST SUMMARY\n");
+    printf("----------------------------------------\n");
+    printf("Total tests run: %d\n", total_tests);
+    printf("Tests passed:    %d\n", tests_passed);
+    printf("Tests failed:    %d\n", tests_failed);
+
+    if (tests_failed == 0) {
+        printf("\nALL TESTS PASSED!\n");
+    } else {
+        printf("\nSOME TESTS FAILED!\n");
+    }
+}
+
+int main() {
+    printf("\nStarting Adaptive Polling Unit Tests\n");
+    printf("========================================\n");
+
+    test_switch_to_polling();
+    test_polling_and_back();
+
+    print_test_summary();
+
+    return (tests_failed == 0) ? 0 : 1;
+}
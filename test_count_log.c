@@ -0,0 +1,207 @@
+#include <stdio.h>
+#include "event_monitor.h"
+#include "count_log.h"
+#include "count_log_reader.h"
+#include "gpio_hal.h"
+#include "rtos_api.h"
+
+// Mock state and test tracking
+static gpio_mask_t simulated_state = 0;
+static uint32_t simulated_time = 0;
+static void (*static_callback)(gpio_mask_t new_state) = NULL;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Mocks for HAL functions
+gpio_mask_t gpio_read_input(void) {
+    return simulated_state;
+}
+
+void gpio_register_callback(void (*callback)(gpio_mask_t new_state)) {
+    static_callback = callback;
+}
+
+uint32_t gpio_read_timestamp(void) {
+    return simulated_time;
+}
+
+void gpio_set_interrupt_mask(gpio_mask_t mask) {
+    (void)mask;
+}
+
+// Mocks for RTOS functions
+void rtos_mutex_lock(void) {}
+void rtos_mutex_unlock(void) {}
+void rtos_task_delay_ms(uint32_t ms) { (void)ms; }
+void rtos_task_create(rtos_task_t* task, void (*task_fn)(void*), void* arg) {
+    (void)task; (void)task_fn; (void)arg;
+}
+
+void report_event_count(uint32_t count) {
+    (void)count;
+}
+
+// Windows as logged, for checking the decoder
+#define WINDOWS_RECORDED 1024
+static uint32_t window_times[WINDOWS_RECORDED];
+static uint32_t window_counts[WINDOWS_RECORDED][3];
+static uint32_t windows_run = 0;
+
+// Helper function to simulate GPIO changes at a given time
+void simulate_gpio_change(uint32_t time, gpio_mask_t new_state) {
+    simulated_time = time;
+    simulated_state = new_state;
+    if (static_callback) {
+        static_callback(new_state);
+    }
+}
+
+// Closes a window at the given time with pulses on pins 0, 5 and 31
+static void run_window(uint32_t time, uint32_t pulses_0, uint32_t pulses_5, uint32_t pulses_31) {
+    uint32_t i;
+
+    for (i = 0; i < pulses_0 || i < pulses_5 || i < pulses_31; ++i) {
+        simulate_gpio_change(time, (i < pulses_0 ? 0x01u : 0u) | (i < pulses_5 ? 0x20u : 0u) |
+                                   (i < pulses_31 ? 0x80000000u : 0u));
+        simulate_gpio_change(time, 0x00000000);
+    }
+    simulated_time = time;
+    event_monitor_report_window();
+
+    if (windows_run < WINDOWS_RECORDED) {
+        window_times[windows_run] = time;
+        window_counts[windows_run][0] = pulses_0;
+        window_counts[windows_run][1] = pulses_5;
+        window_counts[windows_run][2] = pulses_31;
+    }
+    ++windows_run;
+}
+
+// Decodes the log and returns the number of windows matching the record
+static uint32_t matching_windows(void) {
+    count_log_reader_t reader;
+    count_log_window_t window;
+    const uint8_t* data;
+    uint32_t len;
+    uint32_t matches = 0;
+    uint32_t n = 0;
+
+    data = count_log_data(&len);
+    if (count_log_reader_open(&reader, data, len) != 0) {
+        return 0;
+    }
+    while (count_log_reader_next(&reader, &window) == 1 && n < WINDOWS_RECORDED) {
+        if (window.pin_count == 3 && window.timestamp == window_times[n] &&
+            window.counts[0] == window_counts[n][0] && window.counts[1] == window_counts[n][1] &&
+            window.counts[2] == window_counts[n][2]) {
+            ++matches;
+        }
+        ++n;
+    }
+    return matches;
+}
+
+void check_test_result(const char* test_name, uint32_t expected, uint32_t actual) {
+    printf("  %s: Expected %u, Actual %u -> ", test_name, expected, actual);
+    if (expected == actual) {
+        printf("PASS\n");
+        tests_passed++;
+    } else {
+        printf("FAIL\n");
+        tests_failed++;
+    }
+}
+
+void test_steady_windows() {
+    uint32_t before;
+    uint32_t after;
+    uint32_t i;
+
+    printf("\n1. Testing the size of steady windows...\n");
+
+    simulated_state = 0;
+    event_monitor_init(0xFFFFFFFF);
+    check_test_result("Log initialized", 0, (uint32_t)count_log_init(0x80000021));
+    count_log_data(&before);
+    check_test_result("Header only", COUNT_LOG_HEADER_SIZE, before);
+
+    run_window(1000, 2, 0, 1);
+    run_window(2000, 2, 0, 1);
+    count_log_data(&before);
+    for (i = 3; i <= 12; ++i) {
+        run_window(i * 1000, 2, 0, 1);
+    }
+    count_log_data(&after);
+    check_test_result("Two bytes per steady window", 20, after - before);
+    check_test_result("Steady windows decode", windows_run, matching_windows());
+}
+
+void test_round_trip() {
+    uint32_t seed = 5;
+    uint32_t time = 20000;
+    uint32_t i;
+
+    printf("\n2. Testing round trip of irregular windows...\n");
+
+    count_log_reset();
+    windows_run = 0;
+    for (i = 0; i < 100; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        // Jittered period across the 32-bit timestamp wrap
+        time += 1000 + (seed >> 28) - 8 + (i == 50 ? 0xFFFF0000u : 0u);
+        run_window(time, (seed >> 8) % 4, (seed >> 12) % 2 ? 0 : 200 + (seed >> 16) % 50, (seed >> 20) % 3);
+    }
+    check_test_result("Every window decodes", 100, matching_windows());
+    check_test_result("Nothing dropped", 0, count_log_dropped());
+}
+
+void test_full_log() {
+    uint32_t len;
+    uint32_t i;
+
+    printf("\n3. Testing a full log...\n");
+
+    count_log_reset();
+    windows_run = 0;
+    for (i = 0; windows_run < WINDOWS_RECORDED; ++i) {
+        run_window(i * 977, i % 7, 300 + i % 11, i % 2);
+    }
+    count_log_data(&len);
+    check_test_result("Windows dropped when full", 1, count_log_dropped() > 0);
+    check_test_result("Log within its size", 1, len <= COUNT_LOG_SIZE);
+    check_test_result("Logged windows still decode", WINDOWS_RECORDED - count_log_dropped(), matching_windows());
+
+    count_log_reset();
+    count_log_data(&len);
+    check_test_result("Reset empties the log", COUNT_LOG_HEADER_SIZE, len);
+}
+
+void print_test_summary() {
+    int total_tests = tests_passed + tests_failed;
+
+    printf("\n----------------------------------------\n");
+    printf("TEST SUMMARY\n");
+    printf("----------------------------------------\n");
+    printf("Total tests run: %d\n", total_tests);
+    printf("Tests passed:    %d\n", tests_passed);
+    printf("Tests failed:    %d\n", tests_failed);
+
+    if (tests_failed == 0) {
+        printf("\nALL TESTS PASSED!\n");
+    } else {
+        printf("\nSOME TESTS FAILED!\n");
+    }
+}
+
+int main() {
+    printf("\nStarting Count Log Unit Tests\n");
+    printf("========================================\n");
+
+    test_steady_windows();
+    test_round_trip();
+    test_full_log();
+
+    print_test_summary();
+
+    return (tests_failed == 0) ? 0 : 1;
+}
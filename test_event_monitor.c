@@ -6,8 +6,10 @@
 
 // Mock state and test tracking
 static gpio_mask_t simulated_state = 0;
+static uint32_t simulated_time = 0;
 static void (*static_callback)(gpio_mask_t new_state) = NULL;
 static uint32_t total_events_counted = 0;
+static gpio_mask_t interrupt_mask = 0;
 static int tests_passed = 0;
 static int tests_failed = 0;
 
@@ -20,6 +22,14 @@ void gpio_register_callback(void (*callback)(gpio_mask_t new_state)) {
     static_callback = callback;
 }
 
+uint32_t gpio_read_timestamp(void) {
+    return simulated_time;
+}
+
+void gpio_set_interrupt_mask(gpio_mask_t mask) {
+    interrupt_mask = mask;
+}
+
 // Mocks for RTOS functions
 void rtos_mutex_lock(void) {}
 void rtos_mutex_unlock(void) {}
@@ -204,6 +214,306 @@ void test_partial_mask_with_mixed_transitions() {
     check_test_result("Partial mask mixed transitions", 8, total_events_counted);
 }
 
+// Observer used to verify the change hook
+static uint32_t observed_changes = 0;
+static gpio_mask_t observed_rising = 0;
+static uint32_t observed_timestamp = 0;
+
+static void observer_on_change(const event_change_t* change) {
+    ++observed_changes;
+    observed_rising |= change->rising_edges;
+    observed_timestamp = change->timestamp;
+}
+
+static const event_observer_t test_observer = { observer_on_change, NULL, NULL };
+
+void test_change_observer() {
+    printf("\n7. Testing change observer hook...\n");
+    
+    reset_test_state();
+    observed_changes = 0;
+    observed_rising = 0;
+    
+    event_monitor_init(0x0F);
+    event_monitor_add_observer(&test_observer);
+    
+    simulated_time = 1234;
+    simulate_gpio_change(0x00);
+    simulate_gpio_change(0x31); // Rising edge on bit 0 (monitored) and bits 4, 5 (not)
+    
+    event_monitor_remove_observer(&test_observer);
+    simulate_gpio_change(0x00); // Not observed after removal
+    
+    check_test_result("Observer change count", 2, observed_changes);
+    check_test_result("Observer rising edges", 0x01, observed_rising);
+    check_test_result("Observer timestamp", 1234, observed_timestamp);
+}
+
+void test_batch_processing() {
+    printf("\n8. Testing batch processing...\n");
+    
+    static const gpio_mask_t states[] = { 0x00, 0x03, 0x07, 0x07, 0x05, 0x0F, 0x3F };
+    static const uint32_t times[] = { 10, 20, 30, 40, 50, 60, 70 };
+    
+    reset_test_state();
+    observed_changes = 0;
+    
+    event_monitor_init(0x0F);
+    event_monitor_add_observer(&test_observer);
+    event_monitor_process_batch(states, times, 7);
+    event_monitor_remove_observer(&test_observer);
+    
+    event_monitor_report_window();
+    
+    // Same sequence as test 1 plus an unmonitored change: 5 events
+    check_test_result("Batch rising edges", 5, total_events_counted);
+    check_test_result("Batch observer changes", 7, observed_changes);
+    check_test_result("Batch observer timestamp", 70, observed_timestamp);
+    
+    // Longer than one slice: observers still see every change in order
+    {
+        gpio_mask_t toggles[3 * EVENT_MONITOR_BATCH_SLICE + 5];
+        uint32_t i;
+        
+        for (i = 0; i < sizeof(toggles) / sizeof(toggles[0]); ++i) {
+            toggles[i] = (i & 1u) ? 0x01 : 0x00;
+        }
+        total_events_counted = 0;
+        observed_changes = 0;
+        observed_rising = 0;
+        event_monitor_add_observer(&test_observer);
+        event_monitor_process_batch(toggles, NULL, sizeof(toggles) / sizeof(toggles[0]));
+        event_monitor_remove_observer(&test_observer);
+        event_monitor_report_window();
+        check_test_result("Sliced batch rising edges", sizeof(toggles) / sizeof(toggles[0]) / 2, total_events_counted);
+        check_test_result("Sliced batch observer changes", sizeof(toggles) / sizeof(toggles[0]), observed_changes);
+    }
+}
+
+void test_interrupt_mask() {
+    uint32_t unmonitored;
+
+    printf("\n9. Testing HAL interrupt mask programming...\n");
+    
+    reset_test_state();
+    
+    event_monitor_init(0x0F);
+    check_test_result("Init enables monitored pins", 0x0F, interrupt_mask);
+    
+    event_monitor_set_mask(0x30);
+    check_test_result("Mask update reprograms", 0x30, interrupt_mask);
+    check_test_result("Mask update applied", 0x30, event_monitor_get_mask());
+    
+    event_monitor_watch_pins(0x100);
+    check_test_result("Watched pin enabled", 0x130, interrupt_mask);
+    
+    event_monitor_mask_interrupts(0x10);
+    check_test_result("Masked pin disabled", 0x120, interrupt_mask);
+    event_monitor_mask_interrupts(0);
+    check_test_result("Masked pin restored", 0x130, interrupt_mask);
+    
+    unmonitored = event_monitor_unmonitored_callbacks();
+    simulate_gpio_change(0x100); // Watched pin only
+    simulate_gpio_change(0x110); // Monitored rise
+    simulate_gpio_change(0x100); // Monitored fall
+    event_monitor_sample(0x100); // Polled, no change
+    check_test_result("Unmonitored callbacks counted", 1, event_monitor_unmonitored_callbacks() - unmonitored);
+    
+    event_monitor_report_window();
+    check_test_result("New mask counts edges", 1, total_events_counted);
+}
+
+void test_gated_counting() {
+    static const gpio_mask_t states[] = { 0x000, 0x010, 0x000, 0x200, 0x210, 0x200, 0x210 };
+    
+    printf("\n10. Testing gated counting...\n");
+    
+    reset_test_state();
+    
+    event_monitor_init(0x11);
+    // Flow meter on pin 4 counts only while valve pin 9 is high
+    check_test_result("Gate set", 0, (uint32_t)event_monitor_set_gate(4, 9, 1));
+    
+    simulate_gpio_change(0x010); // Gate closed
+    simulate_gpio_change(0x000);
+    simulate_gpio_change(0x200); // Gate opens
+    simulate_gpio_change(0x210); // Counted
+    simulate_gpio_change(0x200);
+    simulate_gpio_change(0x011); // Gate closes as pins 0 and 4 rise: only pin 0 counts
+    simulate_gpio_change(0x000);
+    simulate_gpio_change(0x210); // Gate opens as pin 4 rises: counted
+    event_monitor_report_window();
+    check_test_result("Gated pulses counted", 3, total_events_counted);
+    
+    // Gate on the low level, through the batch path
+    total_events_counted = 0;
+    check_test_result("Gate replaced", 0, (uint32_t)event_monitor_set_gate(4, 9, 0));
+    event_monitor_process_batch(states, NULL, 7);
+    event_monitor_report_window();
+    check_test_result("Low-level gate in batch", 1, total_events_counted);
+    
+    total_events_counted = 0;
+    event_monitor_clear_gate(4);
+    event_monitor_process_batch(states, NULL, 7);
+    event_monitor_report_window();
+    check_test_result("Ungated after clear", 3, total_events_counted);
+    
+    check_test_result("Invalid gate pin rejected", (uint32_t)-1, (uint32_t)event_monitor_set_gate(4, 32, 1));
+}
+
+void test_peek() {
+    static const gpio_mask_t states[] = { 0x80000000, 0x00000000, 0x80000002 };
+    event_snapshot_t snapshot;
+    
+    printf("\n11. Testing in-window snapshot...\n");
+    
+    reset_test_state();
+    
+    event_monitor_init(0x80000003);
+    event_monitor_report_window(); // Start from an empty window
+    total_events_counted = 0;
+    
+    simulate_gpio_change(0x01);
+    simulate_gpio_change(0x00);
+    event_monitor_peek(&snapshot);
+    check_test_result("Aggregate without per-pin counts", 1, snapshot.count);
+    check_test_result("Per-pin counts off by default", 0, snapshot.pin_counts[0]);
+    event_monitor_report_window();
+    total_events_counted = 0;
+    event_monitor_count_pins(1);
+    
+    simulate_gpio_change(0x01);
+    simulate_gpio_change(0x00);
+    simulate_gpio_change(0x03);
+    event_monitor_peek(&snapshot);
+    check_test_result("Snapshot aggregate", 3, snapshot.count);
+    check_test_result("Snapshot pin 0", 2, snapshot.pin_counts[0]);
+    check_test_result("Snapshot pin 1", 1, snapshot.pin_counts[1]);
+    event_monitor_count_pins(1); // A second consumer must not restart the window
+    event_monitor_peek(&snapshot);
+    check_test_result("Re-enabling keeps pin 0", 2, snapshot.pin_counts[0]);
+
+    event_monitor_process_batch(states, NULL, 3);
+    event_monitor_peek(&snapshot);
+    check_test_result("Batch in snapshot", 6, snapshot.count);
+    check_test_result("Batch pin 31", 2, snapshot.pin_counts[31]);
+    
+    // Counts follow their pins to new ranks
+    event_monitor_set_mask(0x80000002);
+    event_monitor_peek(&snapshot);
+    check_test_result("Pin 1 kept after mask change", 2, snapshot.pin_counts[1]);
+    check_test_result("Pin 31 kept after mask change", 2, snapshot.pin_counts[31]);
+    check_test_result("Unmonitored pin dropped", 0, snapshot.pin_counts[0]);
+    event_monitor_set_mask(0x80000003);
+    
+    event_monitor_report_window();
+    check_test_result("Peek did not reset", 6, total_events_counted);
+    event_monitor_peek(&snapshot);
+    check_test_result("Window close resets snapshot", 0, snapshot.count + snapshot.pin_counts[0] + snapshot.pin_counts[31]);
+    event_monitor_count_pins(0);
+}
+
+static const event_report_t* held_reports[4];
+static int held_count = 0;
+
+static void holding_sink(const event_report_t* report) {
+    held_reports[held_count++ & 3] = report;
+}
+
+static void releasing_sink(const event_report_t* report) {
+    event_monitor_release_report(report);
+}
+
+void test_report_buffers() {
+    const event_report_t* first;
+    uint32_t overruns;
+    
+    printf("\n12. Testing double-buffered reports...\n");
+    
+    reset_test_state();
+    held_count = 0;
+    
+    simulated_time = 100;
+    event_monitor_init(0x0F);
+    event_monitor_count_pins(1);
+    event_monitor_report_window(); // Start from an empty window
+    check_test_result("Sink added", 0, (uint32_t)event_monitor_add_report_sink(holding_sink));
+    check_test_result("Second sink added", 0, (uint32_t)event_monitor_add_report_sink(releasing_sink));
+    overruns = event_monitor_report_overruns();
+    
+    simulate_gpio_change(0x05);
+    simulate_gpio_change(0x00);
+    simulate_gpio_change(0x04);
+    simulated_time = 1100;
+    event_monitor_report_window();
+    first = held_reports[0];
+    check_test_result("Report delivered", 1, (uint32_t)held_count);
+    check_test_result("Report count", 3, first->count);
+    check_test_result("Report pin 2", 2, first->pin_counts[2]);
+    check_test_result("Report active pins", 0x05, first->active_pins);
+    check_test_result("Report end", 1100, first->end_timestamp);
+    
+    simulate_gpio_change(0x0F);
+    simulated_time = 2100;
+    event_monitor_report_window();
+    check_test_result("Next report in the other buffer", 1, (uint32_t)(held_reports[1] != first));
+    check_test_result("Held report unchanged", 3, first->count);
+    check_test_result("Next report start", 1100, held_reports[1]->start_timestamp);
+    
+    event_monitor_release_report(first);
+    event_monitor_report_window();
+    check_test_result("Released buffer reused", 1, (uint32_t)(held_reports[2] == first));
+    check_test_result("No overrun after release", overruns, event_monitor_report_overruns());
+    
+    event_monitor_report_window(); // Reuses the unreleased second report
+    check_test_result("Unreleased report overrun", overruns + 1, event_monitor_report_overruns());
+    
+    event_monitor_remove_report_sink(holding_sink);
+    event_monitor_remove_report_sink(releasing_sink);
+    event_monitor_report_window();
+    check_test_result("Removed sinks not called", 4, (uint32_t)held_count);
+}
+
+static void removing_sink(const event_report_t* report) {
+    // As if another task removed the sink while reports go out
+    event_monitor_remove_report_sink(releasing_sink);
+    event_monitor_release_report(report);
+}
+
+void test_report_sink_changes() {
+    event_report_t foreign;
+    uint32_t overruns;
+
+    printf("\n13. Testing sink changes during delivery...\n");
+
+    reset_test_state();
+    held_count = 0;
+
+    event_monitor_init(0x0F);
+    event_monitor_report_window(); // Reuse both buffers without sinks first
+    event_monitor_report_window();
+    event_monitor_add_report_sink(removing_sink);
+    event_monitor_add_report_sink(releasing_sink);
+    overruns = event_monitor_report_overruns();
+
+    // The sink removed mid-delivery is still called, so it still releases
+    event_monitor_report_window();
+    event_monitor_report_window();
+    event_monitor_report_window();
+    check_test_result("Counted sinks all released", overruns, event_monitor_report_overruns());
+
+    // Releasing anything but a report buffer changes nothing
+    event_monitor_remove_report_sink(removing_sink);
+    event_monitor_add_report_sink(holding_sink);
+    event_monitor_report_window();
+    event_monitor_release_report(NULL);
+    event_monitor_release_report(&foreign);
+    event_monitor_report_window();
+    event_monitor_report_window();
+    check_test_result("Foreign releases ignored", overruns + 1, event_monitor_report_overruns());
+    event_monitor_remove_report_sink(holding_sink);
+}
+
 void print_test_summary() {
     int total_tests = tests_passed + tests_failed;
     
@@ -235,6 +545,13 @@ int main() {
     test_edge_transition_logic();
     test_multiple_bits_simultaneous();
     test_partial_mask_with_mixed_transitions();
+    test_change_observer();
+    test_batch_processing();
+    test_interrupt_mask();
+    test_gated_counting();
+    test_peek();
+    test_report_buffers();
+    test_report_sink_changes();
     
     print_test_summary();
     
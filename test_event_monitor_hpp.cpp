@@ -0,0 +1,188 @@
+#include <stdio.h>
+#include "event_monitor.hpp"
+
+extern "C" {
+#include "event_monitor.h"
+#include "gpio_hal.h"
+#include "rtos_api.h"
+}
+
+using event_monitor::AtomicLock;
+using event_monitor::EdgeMode;
+using event_monitor::EventMonitor;
+using event_monitor::MutexLock;
+using event_monitor::NoLock;
+
+// Mock state and test tracking
+static gpio_mask_t simulated_state = 0;
+static void (*static_callback)(gpio_mask_t new_state) = NULL;
+static uint32_t reported_events = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// The C monitor links against these, so they keep C linkage
+extern "C" {
+
+// Mocks for HAL functions
+gpio_mask_t gpio_read_input(void) {
+    return simulated_state;
+}
+
+void gpio_register_callback(void (*callback)(gpio_mask_t new_state)) {
+    static_callback = callback;
+}
+
+uint32_t gpio_read_timestamp(void) {
+    return 0;
+}
+
+void gpio_set_interrupt_mask(gpio_mask_t mask) {
+    (void)mask;
+}
+
+// Mocks for RTOS functions
+void rtos_mutex_lock(void) {}
+void rtos_mutex_unlock(void) {}
+void rtos_task_delay_ms(uint32_t ms) { (void)ms; }
+void rtos_task_create(rtos_task_t* task, void (*task_fn)(void*), void* arg) {
+    (void)task; (void)task_fn; (void)arg;
+}
+
+void report_event_count(uint32_t count) {
+    reported_events = count;
+}
+
+}
+
+// Masks and edges are folded at compile time
+static_assert(EventMonitor<8, NoLock, EdgeMode::Rising>::mask == 0xFF, "full 8-bit mask");
+static_assert(EventMonitor<32, NoLock, EdgeMode::Rising, 0x2D>::edges(0x00, 0xFF) == 0x2D, "rising");
+static_assert(EventMonitor<32, NoLock, EdgeMode::Falling, 0x2D>::edges(0xFF, 0xF0) == 0x0D, "falling");
+static_assert(EventMonitor<16, NoLock, EdgeMode::Both, 0x00F0>::edges(0x0030, 0x0050) == 0x0060, "both");
+static_assert(sizeof(EventMonitor<8, NoLock, EdgeMode::Rising>) == 8, "no per-instance mask storage");
+
+// Helper function to simulate GPIO changes
+void simulate_gpio_change(gpio_mask_t new_state) {
+    simulated_state = new_state;
+    if (static_callback) {
+        static_callback(new_state);
+    }
+}
+
+void check_test_result(const char* test_name, uint32_t expected, uint32_t actual) {
+    printf("  %s: Expected %u, Actual %u -> ", test_name, expected, actual);
+    if (expected == actual) {
+        printf("PASS\n");
+        tests_passed++;
+    } else {
+        printf("FAIL\n");
+        tests_failed++;
+    }
+}
+
+// Pseudo-random port states, mostly single-pin changes
+static uint32_t next_state(uint32_t* seed, uint32_t previous) {
+    *seed = *seed * 1103515245u + 12345u;
+    return (*seed & 0x100) ? previous ^ (1u << ((*seed >> 16) & 31)) : (*seed >> 3) ^ (*seed << 13);
+}
+
+void test_matches_c_monitor() {
+    EventMonitor<32, MutexLock, EdgeMode::Rising, 0x2D> mutex_monitor;
+    EventMonitor<32, AtomicLock, EdgeMode::Rising, 0x2D> atomic_monitor;
+    EventMonitor<32, NoLock, EdgeMode::Rising, 0x2D> plain_monitor;
+    uint32_t seed = 2024;
+    uint32_t state = 0;
+    uint32_t window;
+    uint32_t i;
+
+    printf("\n1. Testing rising-edge counts against event_monitor.c...\n");
+
+    simulated_state = 0;
+    event_monitor_init(0x2D);
+
+    for (window = 0; window < 3; ++window) {
+        for (i = 0; i < 10000; ++i) {
+            state = next_state(&seed, state);
+            simulate_gpio_change(state);
+            mutex_monitor.on_change(state);
+            atomic_monitor.on_change(state);
+            plain_monitor.on_change(state);
+        }
+        event_monitor_report_window();
+        check_test_result("Mutex policy matches C", reported_events, mutex_monitor.take_count());
+        check_test_result("Atomic policy matches C", reported_events, atomic_monitor.take_count());
+        check_test_result("No-lock policy matches C", reported_events, plain_monitor.take_count());
+    }
+}
+
+void test_batch_matches_c_monitor() {
+    static gpio_mask_t states[512];
+    EventMonitor<32, NoLock, EdgeMode::Rising, 0x2D> monitor(simulated_state);
+    uint32_t seed = 77;
+    uint32_t state = simulated_state;
+    uint32_t i;
+
+    printf("\n2. Testing batch counts against event_monitor.c...\n");
+
+    for (i = 0; i < 512; ++i) {
+        state = next_state(&seed, state);
+        states[i] = state;
+    }
+    event_monitor_process_batch(states, NULL, 512);
+    monitor.process_batch(states, 512);
+
+    event_monitor_report_window();
+    check_test_result("Batch matches C", reported_events, monitor.take_count());
+    check_test_result("Previous state carried", states[511], monitor.previous_state());
+}
+
+void test_edge_modes_and_widths() {
+    EventMonitor<8, NoLock, EdgeMode::Falling, 0x0F> falling;
+    EventMonitor<16, NoLock, EdgeMode::Both> both;
+    EventMonitor<64, NoLock, EdgeMode::Rising> wide;
+
+    printf("\n3. Testing edge modes and port widths...\n");
+
+    falling.on_change(0xFF);
+    falling.on_change(0xF0);    // Falls on bits 0-3
+    falling.on_change(0x00);    // Falls on unmasked bits only
+    check_test_result("Falling edges on masked pins", 4, falling.take_count());
+
+    both.on_change(0x8001);
+    both.on_change(0x0001);
+    check_test_result("Both edges", 3, both.take_count());
+
+    wide.on_change(0x8000000100000000ull);
+    check_test_result("Rising edges above bit 31", 2, wide.take_count());
+    check_test_result("Count reset after take", 0, wide.take_count());
+}
+
+void print_test_summary() {
+    int total_tests = tests_passed + tests_failed;
+
+    printf("\n----------------------------------------\n");
+    printf("TEST SUMMARY\n");
+    printf("----------------------------------------\n");
+    printf("Total tests run: %d\n", total_tests);
+    printf("Tests passed:    %d\n", tests_passed);
+    printf("Tests failed:    %d\n", tests_failed);
+
+    if (tests_failed == 0) {
+        printf("\nALL TESTS PASSED!\n");
+    } else {
+        printf("\nSOME TESTS FAILED!\n");
+    }
+}
+
+int main() {
+    printf("\nStarting C++ Front-End Unit Tests\n");
+    printf("========================================\n");
+
+    test_matches_c_monitor();
+    test_batch_matches_c_monitor();
+    test_edge_modes_and_widths();
+
+    print_test_summary();
+
+    return (tests_failed == 0) ? 0 : 1;
+}
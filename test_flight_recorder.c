@@ -0,0 +1,178 @@
+#include <stdio.h>
+#include "event_monitor.h"
+#include "flight_recorder.h"
+#include "gpio_hal.h"
+#include "rtos_api.h"
+
+// Mock state and test tracking
+static gpio_mask_t simulated_state = 0;
+static uint32_t simulated_time = 0;
+static void (*static_callback)(gpio_mask_t new_state) = NULL;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+static flight_recorder_entry_t entries[FLIGHT_RECORDER_DEPTH];
+
+// Mocks for HAL functions
+gpio_mask_t gpio_read_input(void) {
+    return simulated_state;
+}
+
+void gpio_register_callback(void (*callback)(gpio_mask_t new_state)) {
+    static_callback = callback;
+}
+
+uint32_t gpio_read_timestamp(void) {
+    return simulated_time;
+}
+
+void gpio_set_interrupt_mask(gpio_mask_t mask) {
+    (void)mask;
+}
+
+// Mocks for RTOS functions
+void rtos_mutex_lock(void) {}
+void rtos_mutex_unlock(void) {}
+void rtos_task_delay_ms(uint32_t ms) { (void)ms; }
+void rtos_task_create(rtos_task_t* task, void (*task_fn)(void*), void* arg) {
+    (void)task; (void)task_fn; (void)arg;
+}
+
+void report_event_count(uint32_t count) {
+    (void)count;
+}
+
+// Helper function to simulate GPIO changes at a given time
+void simulate_gpio_change(uint32_t time, gpio_mask_t new_state) {
+    simulated_time = time;
+    simulated_state = new_state;
+    if (static_callback) {
+        static_callback(new_state);
+    }
+}
+
+void check_test_result(const char* test_name, uint32_t expected, uint32_t actual) {
+    printf("  %s: Expected %u, Actual %u -> ", test_name, expected, actual);
+    if (expected == actual) {
+        printf("PASS\n");
+        tests_passed++;
+    } else {
+        printf("FAIL\n");
+        tests_failed++;
+    }
+}
+
+void test_full_observer_table() {
+    static const event_observer_t filler = { NULL, NULL, NULL };
+    uint32_t recovered = 1;
+    uint32_t count;
+    int i;
+
+    printf("\n1. Testing a full observer table...\n");
+
+    for (i = 0; i < EVENT_MONITOR_MAX_OBSERVERS; ++i) {
+        event_monitor_add_observer(&filler);
+    }
+    check_test_result("Init reports the failure", (uint32_t)-1, (uint32_t)flight_recorder_init(&recovered));
+    check_test_result("Nothing recovered on cold boot", 0, recovered);
+
+    simulated_state = 0;
+    event_monitor_init(0x01);
+    simulate_gpio_change(5, 0x01);
+    count = flight_recorder_dump(entries, FLIGHT_RECORDER_DEPTH);
+    check_test_result("Nothing recorded while unregistered", 0, count);
+
+    event_monitor_remove_observer(&filler);
+}
+
+void test_cold_boot_and_partial_ring() {
+    uint32_t recovered = 1;
+    uint32_t count;
+
+    printf("\n2. Testing a cold boot with a partly filled ring...\n");
+
+    check_test_result("Recorder started", 0, (uint32_t)flight_recorder_init(&recovered));
+    check_test_result("Nothing recorded to recover", 0, recovered);
+    simulated_state = 0;
+    event_monitor_init(0x01);
+
+    simulate_gpio_change(10, 0x01);
+    simulate_gpio_change(20, 0x03);
+    simulate_gpio_change(30, 0x02);
+
+    count = flight_recorder_dump(entries, FLIGHT_RECORDER_DEPTH);
+    check_test_result("Entries recorded", 3, count);
+    check_test_result("Oldest timestamp", 10, entries[0].timestamp);
+    check_test_result("Rising edges kept", 0x01, entries[0].rising_edges);
+    check_test_result("Unmonitored rise not an edge", 0x00, entries[1].rising_edges);
+    check_test_result("Newest state", 0x02, entries[2].new_state);
+}
+
+void test_wraparound() {
+    uint32_t count;
+    uint32_t i;
+
+    printf("\n3. Testing that only the last entries are kept...\n");
+
+    for (i = 1; i <= 3 * FLIGHT_RECORDER_DEPTH; ++i) {
+        simulate_gpio_change(1000 + i, i & 1);
+    }
+    count = flight_recorder_dump(entries, FLIGHT_RECORDER_DEPTH);
+    check_test_result("Ring is full", FLIGHT_RECORDER_DEPTH, count);
+    check_test_result("Oldest kept entry", 1000 + 2 * FLIGHT_RECORDER_DEPTH + 1, entries[0].timestamp);
+    check_test_result("Newest entry", 1000 + 3 * FLIGHT_RECORDER_DEPTH, entries[count - 1].timestamp);
+
+    count = flight_recorder_dump(entries, 4);
+    check_test_result("Dump limited to max", 4, count);
+    check_test_result("Limited dump ends with newest", 1000 + 3 * FLIGHT_RECORDER_DEPTH, entries[3].timestamp);
+}
+
+void test_warm_reset_recovery() {
+    uint32_t recovered = 0;
+    uint32_t count;
+
+    printf("\n4. Testing recovery after a warm reset...\n");
+
+    // Static RAM keeps its contents here, as a retained section would
+    flight_recorder_init(&recovered);
+    check_test_result("History recovered", FLIGHT_RECORDER_DEPTH, recovered);
+    count = flight_recorder_dump(entries, FLIGHT_RECORDER_DEPTH);
+    check_test_result("Pre-reset newest entry", 1000 + 3 * FLIGHT_RECORDER_DEPTH, entries[count - 1].timestamp);
+
+    // Registered once: each change is recorded once
+    simulate_gpio_change(5000, 0x00);
+    simulate_gpio_change(5001, 0x01);
+    count = flight_recorder_dump(entries, FLIGHT_RECORDER_DEPTH);
+    check_test_result("New entries appended once", 5000, entries[count - 2].timestamp);
+}
+
+void print_test_summary() {
+    int total_tests = tests_passed + tests_failed;
+
+    printf("\n----------------------------------------\n");
+    printf("TEST SUMMARY\n");
+    printf("----------------------------------------\n");
+    printf("Total tests run: %d\n", total_tests);
+    printf("Tests passed:    %d\n", tests_passed);
+    printf("Tests failed:    %d\n", tests_failed);
+
+    if (tests_failed == 0) {
+        printf("\nALL TESTS PASSED!\n");
+    } else {
+        printf("\nSOME TESTS FAILED!\n");
+    }
+}
+
+int main() {
+    printf("\nStarting Flight Recorder Unit Tests\n");
+    printf("========================================\n");
+
+    test_full_observer_table();
+    test_cold_boot_and_partial_ring();
+    test_wraparound();
+    test_warm_reset_recovery();
+
+    print_test_summary();
+
+    return (tests_failed == 0) ? 0 : 1;
+}
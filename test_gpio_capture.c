@@ -0,0 +1,213 @@
+#include <stdio.h>
+#include "event_monitor.h"
+#include "gpio_capture.h"
+#include "gpio_hal.h"
+#include "rtos_api.h"
+
+// Mock state and test tracking
+static gpio_mask_t simulated_state = 0;
+static uint32_t simulated_time = 0;
+static gpio_mask_t interrupt_mask = 0;
+static void (*static_callback)(gpio_mask_t new_state) = NULL;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+static gpio_capture_sample_t samples[GPIO_CAPTURE_DEPTH];
+
+// Mocks for HAL functions
+gpio_mask_t gpio_read_input(void) {
+    return simulated_state;
+}
+
+void gpio_register_callback(void (*callback)(gpio_mask_t new_state)) {
+    static_callback = callback;
+}
+
+uint32_t gpio_read_timestamp(void) {
+    return simulated_time;
+}
+
+void gpio_set_interrupt_mask(gpio_mask_t mask) {
+    interrupt_mask = mask;
+}
+
+// Mocks for RTOS functions
+void rtos_mutex_lock(void) {}
+void rtos_mutex_unlock(void) {}
+void rtos_task_delay_ms(uint32_t ms) { (void)ms; }
+void rtos_task_create(rtos_task_t* task, void (*task_fn)(void*), void* arg) {
+    (void)task; (void)task_fn; (void)arg;
+}
+
+void report_event_count(uint32_t count) {
+    (void)count;
+}
+
+// Helper function to simulate GPIO changes at a given time
+void simulate_gpio_change(uint32_t time, gpio_mask_t new_state) {
+    simulated_time = time;
+    simulated_state = new_state;
+    if (static_callback) {
+        static_callback(new_state);
+    }
+}
+
+void check_test_result(const char* test_name, uint32_t expected, uint32_t actual) {
+    printf("  %s: Expected %u, Actual %u -> ", test_name, expected, actual);
+    if (expected == actual) {
+        printf("PASS\n");
+        tests_passed++;
+    } else {
+        printf("FAIL\n");
+        tests_failed++;
+    }
+}
+
+void test_edge_trigger_pre_post() {
+    gpio_capture_trigger_t trigger = { GPIO_TRIGGER_RISING, 0x80, 0, 0, 0 };
+    uint32_t trigger_pos = 0;
+    uint32_t count;
+    uint32_t i;
+
+    printf("\n1. Testing edge trigger with pre- and post-trigger samples...\n");
+
+    simulated_state = 0;
+    event_monitor_init(0x0F);
+    gpio_capture_arm(&trigger, 4, 3);
+
+    // 20 toggles of bit 0, then bit 7 rises, then 10 more toggles
+    for (i = 1; i <= 20; ++i) {
+        simulate_gpio_change(i, i & 1);
+    }
+    check_test_result("Armed before trigger", GPIO_CAPTURE_ARMED, gpio_capture_status());
+    simulate_gpio_change(100, 0x80);
+    check_test_result("Triggered", GPIO_CAPTURE_TRIGGERED, gpio_capture_status());
+    for (i = 1; i <= 10; ++i) {
+        simulate_gpio_change(100 + i, 0x80 | (i & 1));
+    }
+    check_test_result("Frozen after post samples", GPIO_CAPTURE_DONE, gpio_capture_status());
+
+    count = gpio_capture_read(samples, GPIO_CAPTURE_DEPTH, &trigger_pos);
+    check_test_result("Samples captured", 8, count);
+    check_test_result("Trigger position", 4, trigger_pos);
+    check_test_result("First pre-trigger timestamp", 17, samples[0].timestamp);
+    check_test_result("Trigger state", 0x80, samples[trigger_pos].state);
+    check_test_result("Last post-trigger timestamp", 103, samples[count - 1].timestamp);
+}
+
+void test_pattern_trigger_short_history() {
+    gpio_capture_trigger_t trigger = { GPIO_TRIGGER_PATTERN, 0x0C, 0x08, 0, 0 };
+    uint32_t trigger_pos = 0;
+    uint32_t count;
+
+    printf("\n2. Testing pattern trigger soon after arming...\n");
+
+    simulated_state = 0;
+    event_monitor_init(0x0F);
+    gpio_capture_arm(&trigger, 16, 1);
+
+    simulate_gpio_change(1, 0x04);
+    simulate_gpio_change(2, 0x0C);   // Bits 2,3 = 1,1: no match
+    simulate_gpio_change(3, 0x08);   // Bits 2,3 = 0,1: trigger
+    simulate_gpio_change(4, 0x00);
+    simulate_gpio_change(5, 0x08);   // After the capture froze: not recorded
+
+    count = gpio_capture_read(samples, GPIO_CAPTURE_DEPTH, &trigger_pos);
+    check_test_result("Samples captured", 4, count);
+    check_test_result("Trigger position", 2, trigger_pos);
+    check_test_result("Trigger timestamp", 3, samples[trigger_pos].timestamp);
+}
+
+void test_rate_trigger() {
+    gpio_capture_trigger_t trigger = { GPIO_TRIGGER_RATE, 0x01, 0, 5, 100 };
+    uint32_t trigger_pos = 0;
+    uint32_t i;
+
+    printf("\n3. Testing rate threshold trigger...\n");
+
+    simulated_state = 0;
+    simulated_time = 0;
+    event_monitor_init(0x01);
+    gpio_capture_arm(&trigger, 2, 0);
+
+    // 4 rising edges per 100 ticks stays below the threshold
+    for (i = 0; i < 40; ++i) {
+        simulate_gpio_change(i * 25 / 2, (i & 1) ^ 1);
+    }
+    check_test_result("Slow rate does not trigger", GPIO_CAPTURE_ARMED, gpio_capture_status());
+
+    // A burst of 5 rising edges within 100 ticks triggers
+    for (i = 0; i < 10; ++i) {
+        simulate_gpio_change(1000 + i * 5, (i & 1) ^ 1);
+    }
+    check_test_result("Burst triggers", GPIO_CAPTURE_DONE, gpio_capture_status());
+    gpio_capture_read(samples, GPIO_CAPTURE_DEPTH, &trigger_pos);
+    check_test_result("Trigger on fifth burst edge", 1040, samples[trigger_pos].timestamp);
+}
+
+void test_invalid_arm() {
+    gpio_capture_trigger_t trigger = { GPIO_TRIGGER_RISING, 0x01, 0, 0, 0 };
+
+    printf("\n4. Testing invalid requests...\n");
+
+    check_test_result("Pre plus post larger than ring", (uint32_t)-1,
+                      (uint32_t)gpio_capture_arm(&trigger, GPIO_CAPTURE_DEPTH / 2, GPIO_CAPTURE_DEPTH / 2));
+    gpio_capture_disarm();
+    check_test_result("Nothing to read while idle", 0, gpio_capture_read(samples, GPIO_CAPTURE_DEPTH, NULL));
+}
+
+void test_trigger_pins_released() {
+    gpio_capture_trigger_t first = { GPIO_TRIGGER_RISING, 0x80, 0, 0, 0 };
+    gpio_capture_trigger_t second = { GPIO_TRIGGER_FALLING, 0x10, 0, 0, 0 };
+    int i;
+
+    printf("\n5. Testing trigger pin interrupts across re-arming...\n");
+
+    simulated_state = 0;
+    event_monitor_init(0x01);
+    gpio_capture_arm(&first, 2, 2);
+    check_test_result("Trigger pin enabled", 0x81, interrupt_mask);
+    gpio_capture_arm(&second, 2, 2);
+    check_test_result("Re-arming replaces the trigger pin", 0x11, interrupt_mask);
+    gpio_capture_disarm();
+    check_test_result("Disarming releases it", 0x01, interrupt_mask);
+
+    // More re-arms than a watch count holds
+    for (i = 0; i < 300; ++i) {
+        gpio_capture_arm(&first, 2, 2);
+    }
+    gpio_capture_disarm();
+    check_test_result("Released after many re-arms", 0x01, interrupt_mask);
+}
+
+void print_test_summary() {
+    int total_tests = tests_passed + tests_failed;
+
+    printf("\n----------------------------------------\n");
+    printf("TEST SUMMARY\n");
+    printf("----------------------------------------\n");
+    printf("Total tests run: %d\n", total_tests);
+    printf("Tests passed:    %d\n", tests_passed);
+    printf("Tests failed:    %d\n", tests_failed);
+
+    if (tests_failed == 0) {
+        printf("\nALL TESTS PASSED!\n");
+    } else {
+        printf("\nSOME TESTS FAILED!\n");
+    }
+}
+
+int main() {
+    printf("\nStarting Triggered Capture Unit Tests\n");
+    printf("========================================\n");
+
+    test_edge_trigger_pre_post();
+    test_pattern_trigger_short_history();
+    test_rate_trigger();
+    test_invalid_arm();
+    test_trigger_pins_released();
+
+    print_test_summary();
+
+    return (tests_failed == 0) ? 0 : 1;
+}
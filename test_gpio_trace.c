@@ -0,0 +1,248 @@
+#include <stdio.h>
+#include <string.h>
+#include "event_monitor.h"
+#include "gpio_hal.h"
+#include "gpio_trace.h"
+#include "gpio_trace_reader.h"
+#include "rtos_api.h"
+
+// Mock state and test tracking
+static gpio_mask_t simulated_state = 0;
+static uint32_t simulated_time = 0;
+static gpio_mask_t interrupt_mask = 0;
+static void (*static_callback)(gpio_mask_t new_state) = NULL;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Captured trace bytes
+static uint8_t trace_data[64 * 1024];
+static uint32_t trace_len = 0;
+
+// Mocks for HAL functions
+gpio_mask_t gpio_read_input(void) {
+    return simulated_state;
+}
+
+void gpio_register_callback(void (*callback)(gpio_mask_t new_state)) {
+    static_callback = callback;
+}
+
+uint32_t gpio_read_timestamp(void) {
+    return simulated_time;
+}
+
+void gpio_set_interrupt_mask(gpio_mask_t mask) {
+    interrupt_mask = mask;
+}
+
+// Mocks for RTOS functions
+void rtos_mutex_lock(void) {}
+void rtos_mutex_unlock(void) {}
+void rtos_task_delay_ms(uint32_t ms) { (void)ms; }
+void rtos_task_create(rtos_task_t* task, void (*task_fn)(void*), void* arg) {
+    (void)task; (void)task_fn; (void)arg;
+}
+
+void report_event_count(uint32_t count) {
+    (void)count;
+}
+
+static void memory_sink(const uint8_t* data, uint32_t len, void* ctx) {
+    (void)ctx;
+    if (trace_len + len <= sizeof(trace_data)) {
+        memcpy(trace_data + trace_len, data, len);
+        trace_len += len;
+    }
+}
+
+// Helper function to simulate GPIO changes at a given time
+void simulate_gpio_change(uint32_t time, gpio_mask_t new_state) {
+    simulated_time = time;
+    simulated_state = new_state;
+    if (static_callback) {
+        static_callback(new_state);
+    }
+}
+
+void check_test_result(const char* test_name, uint32_t expected, uint32_t actual) {
+    printf("  %s: Expected %u, Actual %u -> ", test_name, expected, actual);
+    if (expected == actual) {
+        printf("PASS\n");
+        tests_passed++;
+    } else {
+        printf("FAIL\n");
+        tests_failed++;
+    }
+}
+
+void test_round_trip() {
+    gpio_trace_reader_t reader;
+    gpio_trace_record_t record;
+    uint32_t records = 0;
+    uint32_t mismatches = 0;
+
+    printf("\n1. Testing record and decode round trip...\n");
+
+    trace_len = 0;
+    simulated_state = 0;
+    simulated_time = 100;
+    event_monitor_init(0x0F);
+    gpio_trace_start(0xFF, 1000000, memory_sink, NULL);
+
+    simulate_gpio_change(110, 0x01);
+    simulate_gpio_change(125, 0x03);
+    simulate_gpio_change(130, 0x103); // Bit 8 is not traced: no record
+    simulate_gpio_change(200, 0x80);
+    gpio_trace_stop();
+
+    check_test_result("Header parsed", 0, (uint32_t)gpio_trace_reader_open(&reader, trace_data, trace_len));
+    check_test_result("Header mask", 0xFF, reader.header.mask);
+    check_test_result("Header clock", 1000000, reader.header.clock_hz);
+    check_test_result("Header width", 32, reader.header.width);
+
+    while (gpio_trace_reader_next(&reader, &record) == 1) {
+        static const uint32_t times[] = { 110, 125, 200 };
+        static const gpio_mask_t states[] = { 0x01, 0x03, 0x80 };
+        if (records >= 3 || record.timestamp != times[records] || record.state != states[records]) {
+            ++mismatches;
+        }
+        ++records;
+    }
+    check_test_result("Records decoded", 3, records);
+    check_test_result("Record mismatches", 0, mismatches);
+}
+
+void test_timestamp_wrap_and_blocks() {
+    gpio_trace_reader_t reader;
+    gpio_trace_record_t record;
+    uint32_t records = 0;
+    uint32_t mismatches = 0;
+    uint64_t expected_time = 0xFFFFFF00u;
+    uint32_t i;
+
+    printf("\n2. Testing timestamp wrap across many blocks...\n");
+
+    trace_len = 0;
+    simulated_state = 0;
+    simulated_time = 0xFFFFFF00u;
+    event_monitor_init(0x01);
+    gpio_trace_start(0x01, 1000000, memory_sink, NULL);
+
+    // Enough records to fill several blocks, flushing like the monitor task would
+    for (i = 1; i <= 1000; ++i) {
+        simulate_gpio_change(0xFFFFFF00u + i * 7, i & 1);
+        if (i % 50 == 0) {
+            gpio_trace_flush();
+        }
+    }
+    gpio_trace_stop();
+
+    gpio_trace_reader_open(&reader, trace_data, trace_len);
+    while (gpio_trace_reader_next(&reader, &record) == 1) {
+        ++records;
+        expected_time += 7;
+        if (record.timestamp != expected_time || record.state != (records & 1)) {
+            ++mismatches;
+        }
+    }
+    check_test_result("Records decoded", 1000, records);
+    check_test_result("Record mismatches", 0, mismatches);
+    check_test_result("Records dropped", 0, gpio_trace_dropped());
+}
+
+void test_overrun_drops() {
+    gpio_trace_reader_t reader;
+    gpio_trace_record_t record;
+    uint32_t records = 0;
+    uint32_t dropped = 0;
+    gpio_mask_t last_state = 0;
+    uint32_t i;
+
+    printf("\n3. Testing overrun without flushing...\n");
+
+    trace_len = 0;
+    simulated_state = 0;
+    simulated_time = 0;
+    event_monitor_init(0x01);
+    gpio_trace_start(0x01, 1000000, memory_sink, NULL);
+
+    // Never flushed: both buffers fill and the rest is dropped
+    for (i = 1; i <= 2000; ++i) {
+        simulate_gpio_change(i, i & 1);
+    }
+    gpio_trace_stop();
+
+    gpio_trace_reader_open(&reader, trace_data, trace_len);
+    while (gpio_trace_reader_next(&reader, &record) == 1) {
+        ++records;
+        last_state = record.state;
+    }
+    gpio_trace_reader_open(&reader, trace_data, trace_len);
+    while (gpio_trace_read_block(trace_data, trace_len, &reader.offset, &reader.block) == 1) {
+        dropped += reader.block.dropped;
+    }
+    check_test_result("Records kept plus dropped", 2000, records + dropped);
+    check_test_result("Dropped count reported", gpio_trace_dropped(), dropped);
+    check_test_result("Final state", 0, last_state);
+}
+
+void test_traced_pins_released() {
+    static const event_observer_t filler = { NULL, NULL, NULL };
+    int i;
+
+    printf("\n4. Testing traced pin interrupts across start and stop...\n");
+
+    trace_len = 0;
+    simulated_state = 0;
+    simulated_time = 0;
+    event_monitor_init(0x01);
+    gpio_trace_start(0x30, 1000000, memory_sink, NULL);
+    check_test_result("Traced pins enabled", 0x31, interrupt_mask);
+    gpio_trace_stop();
+    check_test_result("Stop releases them", 0x01, interrupt_mask);
+
+    // A full observer table fails the start before anything is set up
+    trace_len = 0;
+    for (i = 0; i < EVENT_MONITOR_MAX_OBSERVERS; ++i) {
+        event_monitor_add_observer(&filler);
+    }
+    check_test_result("Start fails on a full table", (uint32_t)-1,
+                      (uint32_t)gpio_trace_start(0x30, 1000000, memory_sink, NULL));
+    check_test_result("No header written", 0, trace_len);
+    check_test_result("No pins watched", 0x01, interrupt_mask);
+    event_monitor_remove_observer(&filler);
+    check_test_result("Start succeeds once there is room", 0,
+                      (uint32_t)gpio_trace_start(0x30, 1000000, memory_sink, NULL));
+    gpio_trace_stop();
+}
+
+void print_test_summary() {
+    int total_tests = tests_passed + tests_failed;
+
+    printf("\n----------------------------------------\n");
+    printf("TEST SUMMARY\n");
+    printf("----------------------------------------\n");
+    printf("Total tests run: %d\n", total_tests);
+    printf("Tests passed:    %d\n", tests_passed);
+    printf("Tests failed:    %d\n", tests_failed);
+
+    if (tests_failed == 0) {
+        printf("\nALL TESTS PASSED!\n");
+    } else {
+        printf("\nSOME TESTS FAILED!\n");
+    }
+}
+
+int main() {
+    printf("\nStarting GPIO Trace Unit Tests\n");
+    printf("========================================\n");
+
+    test_round_trip();
+    test_timestamp_wrap_and_blocks();
+    test_overrun_drops();
+    test_traced_pins_released();
+
+    print_test_summary();
+
+    return (tests_failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,214 @@
+#include <stdio.h>
+#include "event_monitor.h"
+#include "pattern_engine.h"
+#include "gpio_hal.h"
+#include "rtos_api.h"
+
+// Mock state and test tracking
+static gpio_mask_t simulated_state = 0;
+static uint32_t simulated_time = 0;
+static gpio_mask_t interrupt_mask = 0;
+static void (*static_callback)(gpio_mask_t new_state) = NULL;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Last window delivered to the report sink
+static uint32_t reported_hits[PATTERN_ENGINE_MAX_PATTERNS];
+static unsigned reported_patterns = 0;
+static uint32_t reported_events = 0;
+
+// Pin 3 rises, then pin 5 rises within 2 ms, then pin 3 falls (1 MHz ticks)
+static const pattern_step_t handshake_steps[] = {
+    { 3, PATTERN_RISE, 0 },
+    { 5, PATTERN_RISE, 2000 },
+    { 3, PATTERN_FALL, 0 }
+};
+
+// Pin 1 changes twice
+static const pattern_step_t toggle_steps[] = {
+    { 1, PATTERN_EITHER, 0 },
+    { 1, PATTERN_EITHER, 0 }
+};
+
+static const pattern_t patterns[] = {
+    { handshake_steps, 3 },
+    { toggle_steps, 2 }
+};
+
+// Mocks for HAL functions
+gpio_mask_t gpio_read_input(void) {
+    return simulated_state;
+}
+
+void gpio_register_callback(void (*callback)(gpio_mask_t new_state)) {
+    static_callback = callback;
+}
+
+uint32_t gpio_read_timestamp(void) {
+    return simulated_time;
+}
+
+void gpio_set_interrupt_mask(gpio_mask_t mask) {
+    interrupt_mask = mask;
+}
+
+// Mocks for RTOS functions
+void rtos_mutex_lock(void) {}
+void rtos_mutex_unlock(void) {}
+void rtos_task_delay_ms(uint32_t ms) { (void)ms; }
+void rtos_task_create(rtos_task_t* task, void (*task_fn)(void*), void* arg) {
+    (void)task; (void)task_fn; (void)arg;
+}
+
+void report_event_count(uint32_t count) {
+    reported_events = count;
+}
+
+static void report_hits(const uint32_t* hits, unsigned pattern_count) {
+    unsigned i;
+
+    for (i = 0; i < pattern_count; ++i) {
+        reported_hits[i] = hits[i];
+    }
+    reported_patterns = pattern_count;
+}
+
+// Helper function to simulate GPIO changes at a given time
+void simulate_gpio_change(uint32_t time, gpio_mask_t new_state) {
+    simulated_time = time;
+    simulated_state = new_state;
+    if (static_callback) {
+        static_callback(new_state);
+    }
+}
+
+void check_test_result(const char* test_name, uint32_t expected, uint32_t actual) {
+    printf("  %s: Expected %u, Actual %u -> ", test_name, expected, actual);
+    if (expected == actual) {
+        printf("PASS\n");
+        tests_passed++;
+    } else {
+        printf("FAIL\n");
+        tests_failed++;
+    }
+}
+
+void test_sequence_with_unrelated_changes() {
+    printf("\n1. Testing a sequence interleaved with other changes...\n");
+
+    simulated_state = 0;
+    event_monitor_init(0x28);
+    check_test_result("Patterns compiled", 0, (uint32_t)pattern_engine_init(patterns, 2, report_hits));
+
+    simulate_gpio_change(100, 0x08);        // Pin 3 rises
+    simulate_gpio_change(400, 0x09);        // Unrelated pin 0
+    simulate_gpio_change(1500, 0x29);       // Pin 5 rises within 2 ms
+    simulate_gpio_change(1800, 0x28);       // Unrelated pin 0
+    simulate_gpio_change(2000, 0x20);       // Pin 3 falls
+    simulate_gpio_change(2100, 0x00);
+
+    event_monitor_report_window();
+    check_test_result("Sink called for both patterns", 2, reported_patterns);
+    check_test_result("Handshake matched", 1, reported_hits[0]);
+    check_test_result("Toggle not matched", 0, reported_hits[1]);
+    check_test_result("Event count still reported", 2, reported_events);
+}
+
+void test_time_limit() {
+    printf("\n2. Testing the time limit between steps...\n");
+
+    simulate_gpio_change(10000, 0x08);      // Pin 3 rises
+    simulate_gpio_change(13000, 0x28);      // Pin 5 rises 3 ms later
+    simulate_gpio_change(13500, 0x20);      // Pin 3 falls
+    simulate_gpio_change(14000, 0x00);
+
+    // A later start is timed on its own
+    simulate_gpio_change(20000, 0x08);
+    simulate_gpio_change(20500, 0x00);
+    simulate_gpio_change(23000, 0x08);
+    simulate_gpio_change(24999, 0x28);      // 1999 ticks after the latest rise
+    simulate_gpio_change(25500, 0x20);
+    simulate_gpio_change(26000, 0x00);
+
+    event_monitor_report_window();
+    check_test_result("Only the timely sequence matched", 1, reported_hits[0]);
+
+    event_monitor_report_window();
+    check_test_result("Hits reset per window", 0, reported_hits[0]);
+}
+
+void test_repeated_matches() {
+    printf("\n3. Testing restart after a match...\n");
+
+    simulate_gpio_change(30000, 0x02);
+    simulate_gpio_change(30001, 0x00);
+    simulate_gpio_change(30002, 0x02);
+    simulate_gpio_change(30003, 0x00);
+    simulate_gpio_change(30004, 0x02);
+
+    event_monitor_report_window();
+    check_test_result("Two toggle pairs", 2, reported_hits[1]);
+}
+
+void test_capacity() {
+    static const pattern_step_t long_steps[17] = { { 0, PATTERN_RISE, 0 } };
+    static const pattern_t too_long[] = {
+        { long_steps, 17 },
+        { long_steps, 17 }
+    };
+    static const pattern_step_t bad_pin[] = { { 32, PATTERN_RISE, 0 } };
+    static const pattern_t bad[] = { { bad_pin, 1 } };
+
+    printf("\n4. Testing table limits...\n");
+
+    check_test_result("Too many steps rejected", (uint32_t)-1, (uint32_t)pattern_engine_init(too_long, 2, report_hits));
+    check_test_result("Pin out of range rejected", (uint32_t)-1, (uint32_t)pattern_engine_init(bad, 1, report_hits));
+}
+
+void test_step_pins_released() {
+    static const pattern_step_t pin7_steps[] = { { 7, PATTERN_RISE, 0 } };
+    static const pattern_t pin7[] = { { pin7_steps, 1 } };
+
+    printf("\n5. Testing step pin interrupts across re-initialization...\n");
+
+    simulated_state = 0;
+    event_monitor_init(0x01);
+    pattern_engine_init(patterns, 2, report_hits);
+    check_test_result("Step pins enabled", 0x2B, interrupt_mask);
+    pattern_engine_init(pin7, 1, report_hits);
+    check_test_result("Re-init replaces them", 0x81, interrupt_mask);
+    pattern_engine_init(pin7, 0, report_hits);
+    check_test_result("No patterns, no step pins", 0x01, interrupt_mask);
+}
+
+void print_test_summary() {
+    int total_tests = tests_passed + tests_failed;
+
+    printf("\n----------------------------------------\n");
+    printf("TEST SUMMARY\n");
+    printf("----------------------------------------\n");
+    printf("Total tests run: %d\n", total_tests);
+    printf("Tests passed:    %d\n", tests_passed);
+    printf("Tests failed:    %d\n", tests_failed);
+
+    if (tests_failed == 0) {
+        printf("\nALL TESTS PASSED!\n");
+    } else {
+        printf("\nSOME TESTS FAILED!\n");
+    }
+}
+
+int main() {
+    printf("\nStarting Pattern Engine Unit Tests\n");
+    printf("========================================\n");
+
+    test_sequence_with_unrelated_changes();
+    test_time_limit();
+    test_repeated_matches();
+    test_capacity();
+    test_step_pins_released();
+
+    print_test_summary();
+
+    return (tests_failed == 0) ? 0 : 1;
+}
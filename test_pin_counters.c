@@ -0,0 +1,154 @@
+#include <stdio.h>
+#include "event_monitor.h"
+#include "pin_counters.h"
+#include "gpio_hal.h"
+#include "rtos_api.h"
+
+// Mock state and test tracking
+static gpio_mask_t simulated_state = 0;
+static uint32_t simulated_time = 0;
+static void (*static_callback)(gpio_mask_t new_state) = NULL;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Last window delivered to the report sink
+static uint32_t reported_counts[PIN_COUNTERS_CAPACITY];
+static gpio_mask_t reported_pins = 0;
+static unsigned reported_count = 0;
+static uint32_t reported_events = 0;
+
+// Mocks for HAL functions
+gpio_mask_t gpio_read_input(void) {
+    return simulated_state;
+}
+
+void gpio_register_callback(void (*callback)(gpio_mask_t new_state)) {
+    static_callback = callback;
+}
+
+uint32_t gpio_read_timestamp(void) {
+    return simulated_time;
+}
+
+void gpio_set_interrupt_mask(gpio_mask_t mask) {
+    (void)mask;
+}
+
+// Mocks for RTOS functions
+void rtos_mutex_lock(void) {}
+void rtos_mutex_unlock(void) {}
+void rtos_task_delay_ms(uint32_t ms) { (void)ms; }
+void rtos_task_create(rtos_task_t* task, void (*task_fn)(void*), void* arg) {
+    (void)task; (void)task_fn; (void)arg;
+}
+
+void report_event_count(uint32_t count) {
+    reported_events = count;
+}
+
+static void report_counts(const uint32_t* counts, gpio_mask_t pins, unsigned count) {
+    unsigned i;
+
+    for (i = 0; i < count; ++i) {
+        reported_counts[i] = counts[i];
+    }
+    reported_pins = pins;
+    reported_count = count;
+}
+
+// Helper function to simulate GPIO changes at a given time
+void simulate_gpio_change(uint32_t time, gpio_mask_t new_state) {
+    simulated_time = time;
+    simulated_state = new_state;
+    if (static_callback) {
+        static_callback(new_state);
+    }
+}
+
+void check_test_result(const char* test_name, uint32_t expected, uint32_t actual) {
+    printf("  %s: Expected %u, Actual %u -> ", test_name, expected, actual);
+    if (expected == actual) {
+        printf("PASS\n");
+        tests_passed++;
+    } else {
+        printf("FAIL\n");
+        tests_failed++;
+    }
+}
+
+void test_rank_index() {
+    printf("\n1. Testing dense counter indices...\n");
+
+    check_test_result("Lowest pin", 0, pin_counters_index(0x80010021, 0));
+    check_test_result("Second pin", 1, pin_counters_index(0x80010021, 5));
+    check_test_result("Third pin", 2, pin_counters_index(0x80010021, 16));
+    check_test_result("Pin 31", 3, pin_counters_index(0x80010021, 31));
+}
+
+void test_dense_counting() {
+    printf("\n2. Testing per-pin counts...\n");
+
+    simulated_state = 0;
+    event_monitor_init(0x800100A1);
+    check_test_result("Counters started", 0, (uint32_t)pin_counters_init(0x80010021, report_counts));
+
+    simulate_gpio_change(1, 0x00000001);
+    simulate_gpio_change(2, 0x80010021);    // Pins 5, 16, 31 rise together
+    simulate_gpio_change(3, 0x00000000);
+    simulate_gpio_change(4, 0x80000080);    // Pin 7 is monitored but not counted
+    simulate_gpio_change(5, 0x00000000);
+    simulate_gpio_change(6, 0x80000002);    // Pin 1 is not monitored
+
+    event_monitor_report_window();
+    check_test_result("Four counters", 4, reported_count);
+    check_test_result("Counted pins reported", 0x80010021, reported_pins);
+    check_test_result("Pin 0", 1, reported_counts[0]);
+    check_test_result("Pin 5", 1, reported_counts[1]);
+    check_test_result("Pin 16", 1, reported_counts[2]);
+    check_test_result("Pin 31", 3, reported_counts[3]);
+    check_test_result("Aggregate count unchanged", 7, reported_events);
+
+    event_monitor_report_window();
+    check_test_result("Counters reset per window", 0, reported_counts[3]);
+}
+
+void test_capacity() {
+    printf("\n3. Testing counter capacity...\n");
+
+    check_test_result("Too many pins rejected", (uint32_t)-1, (uint32_t)pin_counters_init(0x1FF, report_counts));
+    check_test_result("Full capacity accepted", 0, (uint32_t)pin_counters_init(0xFF, report_counts));
+
+    simulate_gpio_change(7, 0x80);
+    event_monitor_report_window();
+    check_test_result("Remapped to new mask", 1, reported_counts[7]);
+}
+
+void print_test_summary() {
+    int total_tests = tests_passed + tests_failed;
+
+    printf("\n----------------------------------------\n");
+    printf("TEST SUMMARY\n");
+    printf("----------------------------------------\n");
+    printf("Total tests run: %d\n", total_tests);
+    printf("Tests passed:    %d\n", tests_passed);
+    printf("Tests failed:    %d\n", tests_failed);
+
+    if (tests_failed == 0) {
+        printf("\nALL TESTS PASSED!\n");
+    } else {
+        printf("\nSOME TESTS FAILED!\n");
+    }
+}
+
+int main() {
+    printf("\nStarting Pin Counter Unit Tests\n");
+    printf("========================================\n");
+
+    test_rank_index();
+    test_dense_counting();
+    test_capacity();
+
+    print_test_summary();
+
+    return (tests_failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,184 @@
+#include <stdio.h>
+#include "event_monitor.h"
+#include "pin_groups.h"
+#include "gpio_hal.h"
+#include "rtos_api.h"
+
+// Mock state and test tracking
+static gpio_mask_t simulated_state = 0;
+static uint32_t simulated_time = 0;
+static void (*static_callback)(gpio_mask_t new_state) = NULL;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Last window delivered to the report sink
+static uint32_t reported_counts[PIN_GROUPS_MAX];
+static unsigned reported_groups = 0;
+static unsigned report_calls = 0;
+static uint32_t reported_events = 0;
+
+// Doors on pins 0-3, flow meters on 4-7, plus overlapping and sparse groups
+static const gpio_mask_t group_masks[] = {
+    0x0000000F,
+    0x000000F0,
+    0x0000003C,
+    0x80000001,
+    0x00FF0000,
+    0xFFFFFFFF
+};
+
+// Mocks for HAL functions
+gpio_mask_t gpio_read_input(void) {
+    return simulated_state;
+}
+
+void gpio_register_callback(void (*callback)(gpio_mask_t new_state)) {
+    static_callback = callback;
+}
+
+uint32_t gpio_read_timestamp(void) {
+    return simulated_time;
+}
+
+void gpio_set_interrupt_mask(gpio_mask_t mask) {
+    (void)mask;
+}
+
+// Mocks for RTOS functions
+void rtos_mutex_lock(void) {}
+void rtos_mutex_unlock(void) {}
+void rtos_task_delay_ms(uint32_t ms) { (void)ms; }
+void rtos_task_create(rtos_task_t* task, void (*task_fn)(void*), void* arg) {
+    (void)task; (void)task_fn; (void)arg;
+}
+
+void report_event_count(uint32_t count) {
+    reported_events = count;
+}
+
+static void report_groups(const uint32_t* counts, unsigned group_count) {
+    unsigned i;
+
+    for (i = 0; i < group_count; ++i) {
+        reported_counts[i] = counts[i];
+    }
+    reported_groups = group_count;
+    ++report_calls;
+}
+
+// Helper function to simulate GPIO changes at a given time
+void simulate_gpio_change(uint32_t time, gpio_mask_t new_state) {
+    simulated_time = time;
+    simulated_state = new_state;
+    if (static_callback) {
+        static_callback(new_state);
+    }
+}
+
+void check_test_result(const char* test_name, uint32_t expected, uint32_t actual) {
+    printf("  %s: Expected %u, Actual %u -> ", test_name, expected, actual);
+    if (expected == actual) {
+        printf("PASS\n");
+        tests_passed++;
+    } else {
+        printf("FAIL\n");
+        tests_failed++;
+    }
+}
+
+void test_group_counts() {
+    printf("\n1. Testing group totals...\n");
+
+    simulated_state = 0;
+    event_monitor_init(0xFFFFFFFF);
+    check_test_result("Groups configured", 0, (uint32_t)pin_groups_init(group_masks, 6, report_groups));
+
+    simulate_gpio_change(1, 0x00000003);    // Two doors
+    simulate_gpio_change(2, 0x00000013);    // One flow meter
+    simulate_gpio_change(3, 0x00000000);
+    simulate_gpio_change(4, 0x80010024);    // Door, flow meter, pin 16 and pin 31
+
+    report_calls = 0;
+    event_monitor_report_window();
+    check_test_result("One report call", 1, report_calls);
+    check_test_result("All groups reported", 6, reported_groups);
+    check_test_result("Doors", 3, reported_counts[0]);
+    check_test_result("Flow meters", 2, reported_counts[1]);
+    check_test_result("Overlapping group", 3, reported_counts[2]);
+    check_test_result("Sparse group", 2, reported_counts[3]);
+    check_test_result("Upper group", 1, reported_counts[4]);
+    check_test_result("Every pin", 7, reported_counts[5]);
+    check_test_result("Aggregate count unchanged", 7, reported_events);
+}
+
+void test_against_brute_force() {
+    uint32_t expected[6] = { 0 };
+    gpio_mask_t previous = simulated_state;
+    gpio_mask_t next;
+    uint32_t seed = 99;
+    uint32_t i;
+    unsigned g;
+    int pin;
+
+    printf("\n2. Testing group totals against a per-pin scan...\n");
+
+    for (i = 0; i < 20000; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        next = (seed >> 3) ^ (seed << 13);
+        for (g = 0; g < 6; ++g) {
+            for (pin = 0; pin < 32; ++pin) {
+                if ((~previous & next & group_masks[g]) & (1u << pin)) {
+                    ++expected[g];
+                }
+            }
+        }
+        simulate_gpio_change(i, next);
+        previous = next;
+    }
+
+    event_monitor_report_window();
+    for (g = 0; g < 6; ++g) {
+        check_test_result("Group matches scan", expected[g], reported_counts[g]);
+    }
+}
+
+void test_limits() {
+    static gpio_mask_t many[PIN_GROUPS_MAX + 1];
+
+    printf("\n3. Testing group limits...\n");
+
+    check_test_result("Too many groups rejected", (uint32_t)-1, (uint32_t)pin_groups_init(many, PIN_GROUPS_MAX + 1, report_groups));
+    check_test_result("Full table accepted", 0, (uint32_t)pin_groups_init(many, PIN_GROUPS_MAX, report_groups));
+    event_monitor_report_window();
+    check_test_result("All groups reported", PIN_GROUPS_MAX, reported_groups);
+}
+
+void print_test_summary() {
+    int total_tests = tests_passed + tests_failed;
+
+    printf("\n----------------------------------------\n");
+    printf("TEST SUMMARY\n");
+    printf("----------------------------------------\n");
+    printf("Total tests run: %d\n", total_tests);
+    printf("Tests passed:    %d\n", tests_passed);
+    printf("Tests failed:    %d\n", tests_failed);
+
+    if (tests_failed == 0) {
+        printf("\nALL TESTS PASSED!\n");
+    } else {
+        printf("\nSOME TESTS FAILED!\n");
+    }
+}
+
+int main() {
+    printf("\nStarting Pin Group Unit Tests\n");
+    printf("========================================\n");
+
+    test_group_counts();
+    test_against_brute_force();
+    test_limits();
+
+    print_test_summary();
+
+    return (tests_failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,203 @@
+#include <stdio.h>
+#include "event_monitor.h"
+#include "quadrature.h"
+#include "gpio_hal.h"
+#include "rtos_api.h"
+
+// Mock state and test tracking
+static gpio_mask_t simulated_state = 0;
+static uint32_t simulated_time = 0;
+static gpio_mask_t interrupt_mask = 0;
+static void (*static_callback)(gpio_mask_t new_state) = NULL;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Last window delivered to the report sink
+static int32_t reported_deltas[QUADRATURE_MAX_PAIRS];
+static uint32_t reported_errors[QUADRATURE_MAX_PAIRS];
+static unsigned reported_pairs = 0;
+static uint32_t reported_events = 0;
+
+// Pins 2/3 and 6/7 carry A/B channels
+static const quadrature_pair_t pairs[] = {
+    { 2, 3 },
+    { 6, 7 }
+};
+
+// Forward Gray sequence of AB as (A << 1) | B
+static const uint32_t gray[4] = { 0, 1, 3, 2 };
+
+static gpio_mask_t encoder_state(uint32_t ab0, uint32_t ab1) {
+    return ((ab0 >> 1) << 2) | ((ab0 & 1u) << 3) | ((ab1 >> 1) << 6) | ((ab1 & 1u) << 7);
+}
+
+// Mocks for HAL functions
+gpio_mask_t gpio_read_input(void) {
+    return simulated_state;
+}
+
+void gpio_register_callback(void (*callback)(gpio_mask_t new_state)) {
+    static_callback = callback;
+}
+
+uint32_t gpio_read_timestamp(void) {
+    return simulated_time;
+}
+
+void gpio_set_interrupt_mask(gpio_mask_t mask) {
+    interrupt_mask = mask;
+}
+
+// Mocks for RTOS functions
+void rtos_mutex_lock(void) {}
+void rtos_mutex_unlock(void) {}
+void rtos_task_delay_ms(uint32_t ms) { (void)ms; }
+void rtos_task_create(rtos_task_t* task, void (*task_fn)(void*), void* arg) {
+    (void)task; (void)task_fn; (void)arg;
+}
+
+void report_event_count(uint32_t count) {
+    reported_events = count;
+}
+
+static void report_pairs(const int32_t* deltas, const uint32_t* errors, unsigned pair_count) {
+    unsigned i;
+
+    for (i = 0; i < pair_count; ++i) {
+        reported_deltas[i] = deltas[i];
+        reported_errors[i] = errors[i];
+    }
+    reported_pairs = pair_count;
+}
+
+// Helper function to simulate GPIO changes at a given time
+void simulate_gpio_change(uint32_t time, gpio_mask_t new_state) {
+    simulated_time = time;
+    simulated_state = new_state;
+    if (static_callback) {
+        static_callback(new_state);
+    }
+}
+
+void check_test_result(const char* test_name, uint32_t expected, uint32_t actual) {
+    printf("  %s: Expected %u, Actual %u -> ", test_name, expected, actual);
+    if (expected == actual) {
+        printf("PASS\n");
+        tests_passed++;
+    } else {
+        printf("FAIL\n");
+        tests_failed++;
+    }
+}
+
+void test_direction_and_resolution() {
+    uint32_t i;
+
+    printf("\n1. Testing direction and 4x resolution...\n");
+
+    simulated_state = 0;
+    event_monitor_init(0x04);
+    check_test_result("Pairs configured", 0, (uint32_t)quadrature_init(pairs, 2, report_pairs));
+
+    // Two full forward cycles on pair 0, three reverse steps on pair 1
+    for (i = 1; i <= 8; ++i) {
+        simulate_gpio_change(i, encoder_state(gray[i & 3], 0));
+    }
+    for (i = 1; i <= 3; ++i) {
+        simulate_gpio_change(100 + i, encoder_state(0, gray[(4 - i) & 3]));
+    }
+
+    event_monitor_report_window();
+    check_test_result("Both pairs reported", 2, reported_pairs);
+    check_test_result("Pair 0 forward", 8, (uint32_t)reported_deltas[0]);
+    check_test_result("Pair 1 reverse", (uint32_t)-3, (uint32_t)reported_deltas[1]);
+    check_test_result("No errors", 0, reported_errors[0] + reported_errors[1]);
+    check_test_result("Rising edges on pin 2 still counted", 2, reported_events);
+
+    event_monitor_report_window();
+    check_test_result("Deltas reset per window", 0, (uint32_t)reported_deltas[0]);
+}
+
+void test_pairs_in_one_change() {
+    printf("\n2. Testing both pairs changing in one callback...\n");
+
+    // Pair 1 is at gray[1]; move pair 0 forward and pair 1 back together
+    simulate_gpio_change(200, encoder_state(gray[1], gray[0]));
+    simulate_gpio_change(201, encoder_state(gray[2], gray[3]));
+
+    event_monitor_report_window();
+    check_test_result("Pair 0 two steps forward", 2, (uint32_t)reported_deltas[0]);
+    check_test_result("Pair 1 two steps back", (uint32_t)-2, (uint32_t)reported_deltas[1]);
+}
+
+void test_invalid_transitions() {
+    printf("\n3. Testing invalid transitions...\n");
+
+    // Both channels of pair 0 change at once: 11 -> 00
+    simulate_gpio_change(300, encoder_state(gray[2], gray[3]) ^ 0x0C);
+    simulate_gpio_change(301, encoder_state(gray[3], gray[3]) ^ 0x0C);
+
+    event_monitor_report_window();
+    check_test_result("Error counted", 1, reported_errors[0]);
+    check_test_result("Position kept on error", 1, (uint32_t)reported_deltas[0]);
+    check_test_result("Other pair unaffected", 0, reported_errors[1]);
+}
+
+void test_configuration() {
+    static const quadrature_pair_t shared[] = { { 1, 2 }, { 2, 4 } };
+    static const quadrature_pair_t same[] = { { 5, 5 } };
+    static const quadrature_pair_t range[] = { { 31, 32 } };
+
+    printf("\n4. Testing configuration checks...\n");
+
+    check_test_result("Shared pin rejected", (uint32_t)-1, (uint32_t)quadrature_init(shared, 2, report_pairs));
+    check_test_result("Same pin rejected", (uint32_t)-1, (uint32_t)quadrature_init(same, 1, report_pairs));
+    check_test_result("Pin out of range rejected", (uint32_t)-1, (uint32_t)quadrature_init(range, 1, report_pairs));
+}
+
+void test_encoder_pins_released() {
+    static const quadrature_pair_t single[] = { { 4, 5 } };
+
+    printf("\n5. Testing encoder pin interrupts across re-initialization...\n");
+
+    simulated_state = 0;
+    event_monitor_init(0x01);
+    quadrature_init(pairs, 2, report_pairs);
+    check_test_result("Encoder pins enabled", 0xCD, interrupt_mask);
+    quadrature_init(single, 1, report_pairs);
+    check_test_result("Re-init replaces them", 0x31, interrupt_mask);
+    quadrature_init(single, 0, report_pairs);
+    check_test_result("No pairs, no encoder pins", 0x01, interrupt_mask);
+}
+
+void print_test_summary() {
+    int total_tests = tests_passed + tests_failed;
+
+    printf("\n----------------------------------------\n");
+    printf("TEST SUMMARY\n");
+    printf("----------------------------------------\n");
+    printf("Total tests run: %d\n", total_tests);
+    printf("Tests passed:    %d\n", tests_passed);
+    printf("Tests failed:    %d\n", tests_failed);
+
+    if (tests_failed == 0) {
+        printf("\nALL TESTS PASSED!\n");
+    } else {
+        printf("\nSOME TESTS FAILED!\n");
+    }
+}
+
+int main() {
+    printf("\nStarting Quadrature Decoder Unit Tests\n");
+    printf("========================================\n");
+
+    test_direction_and_resolution();
+    test_pairs_in_one_change();
+    test_invalid_transitions();
+    test_configuration();
+    test_encoder_pins_released();
+
+    print_test_summary();
+
+    return (tests_failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,157 @@
+#include <stdio.h>
+#include "event_monitor.h"
+#include "sampler.h"
+#include "gpio_hal.h"
+#include "rtos_api.h"
+
+// Mock state and test tracking
+static gpio_mask_t simulated_state = 0;
+static void (*static_callback)(gpio_mask_t new_state) = NULL;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Last values delivered to the report sinks
+static uint32_t reported_samples = 0;
+static uint32_t reported_min_pulse = 0;
+static uint32_t reported_events = 0;
+static int tasks_created = 0;
+
+// Mocks for HAL functions
+gpio_mask_t gpio_read_input(void) {
+    return simulated_state;
+}
+
+void gpio_register_callback(void (*callback)(gpio_mask_t new_state)) {
+    static_callback = callback;
+}
+
+uint32_t gpio_read_timestamp(void) {
+    return 0;
+}
+
+void gpio_set_interrupt_mask(gpio_mask_t mask) {
+    (void)mask;
+}
+
+// Mocks for RTOS functions
+void rtos_mutex_lock(void) {}
+void rtos_mutex_unlock(void) {}
+void rtos_task_delay_ms(uint32_t ms) { (void)ms; }
+void rtos_task_create(rtos_task_t* task, void (*task_fn)(void*), void* arg) {
+    (void)task; (void)task_fn; (void)arg;
+    ++tasks_created;
+}
+
+void report_event_count(uint32_t count) {
+    reported_events = count;
+}
+
+static void report_sampling(uint32_t samples, uint32_t min_pulse_ns) {
+    reported_samples = samples;
+    reported_min_pulse = min_pulse_ns;
+}
+
+void check_test_result(const char* test_name, uint32_t expected, uint32_t actual) {
+    printf("  %s: Expected %u, Actual %u -> ", test_name, expected, actual);
+    if (expected == actual) {
+        printf("PASS\n");
+        tests_passed++;
+    } else {
+        printf("FAIL\n");
+        tests_failed++;
+    }
+}
+
+// Sets the port and takes one sample, as the sampling timer would
+static void sample_state(gpio_mask_t state) {
+    simulated_state = state;
+    sampler_tick();
+}
+
+void test_rates() {
+    printf("\n1. Testing rate checks and pulse widths...\n");
+
+    simulated_state = 0;
+    event_monitor_init(0x03);
+
+    check_test_result("Zero rate rejected", (uint32_t)-1, (uint32_t)sampler_init(0, SAMPLER_TIMER, report_sampling));
+    check_test_result("Task rate must divide 1000 Hz", (uint32_t)-1, (uint32_t)sampler_init(3, SAMPLER_TASK, report_sampling));
+    check_test_result("Task rate above 1000 Hz rejected", (uint32_t)-1, (uint32_t)sampler_init(2000, SAMPLER_TASK, report_sampling));
+    // The monitor task is the only one so far
+    check_test_result("No task for rejected rates", 1, (uint32_t)tasks_created);
+
+    check_test_result("Task sampling at 100 Hz", 0, (uint32_t)sampler_init(100, SAMPLER_TASK, report_sampling));
+    check_test_result("Sampling task created", 2, (uint32_t)tasks_created);
+    check_test_result("10 ms pulses at 100 Hz", 10000000, sampler_min_pulse_ns());
+
+    check_test_result("Timer sampling at 3 MHz", 0, (uint32_t)sampler_init(3000000, SAMPLER_TIMER, report_sampling));
+    check_test_result("Pulse width rounded up", 334, sampler_min_pulse_ns());
+    check_test_result("Task created only once", 2, (uint32_t)tasks_created);
+}
+
+void test_timer_sampling() {
+    printf("\n2. Testing timer-driven sampling...\n");
+
+    check_test_result("Timer sampling at 1 kHz", 0, (uint32_t)sampler_init(1000, SAMPLER_TIMER, report_sampling));
+
+    sample_state(0x01);
+    sample_state(0x01);
+    sample_state(0x03);
+    sample_state(0x00);
+    sample_state(0x04);     // Unmonitored
+    sample_state(0x02);
+
+    event_monitor_report_window();
+    check_test_result("Rising edges counted", 3, reported_events);
+    check_test_result("Samples reported", 6, reported_samples);
+    check_test_result("Pulse width reported", 1000000, reported_min_pulse);
+}
+
+void test_dma_drain() {
+    static const gpio_mask_t buffer[] = { 0x00, 0x01, 0x01, 0x00, 0x01, 0x03, 0x03, 0x00 };
+
+    printf("\n3. Testing DMA buffer draining...\n");
+
+    check_test_result("DMA sampling at 1 MHz", 0, (uint32_t)sampler_init(1000000, SAMPLER_DMA, report_sampling));
+
+    sampler_drain(buffer, 4);
+    sampler_drain(buffer + 4, 4);
+
+    event_monitor_report_window();
+    check_test_result("Edges across buffers counted", 3, reported_events);
+    check_test_result("Buffered samples reported", 8, reported_samples);
+    check_test_result("Pulse width reported", 1000, reported_min_pulse);
+
+    event_monitor_report_window();
+    check_test_result("Samples reset per window", 0, reported_samples);
+}
+
+void print_test_summary() {
+    int total_tests = tests_passed + tests_failed;
+
+    printf("\n----------------------------------------\n");
+    printf("TEST SUMMARY\n");
+    printf("----------------------------------------\n");
+    printf("Total tests run: %d\n", total_tests);
+    printf("Tests passed:    %d\n", tests_passed);
+    printf("Tests failed:    %d\n", tests_failed);
+
+    if (tests_failed == 0) {
+        printf("\nALL TESTS PASSED!\n");
+    } else {
+        printf("\nSOME TESTS FAILED!\n");
+    }
+}
+
+int main() {
+    printf("\nStarting Sampler Unit Tests\n");
+    printf("========================================\n");
+
+    test_rates();
+    test_timer_sampling();
+    test_dma_drain();
+
+    print_test_summary();
+
+    return (tests_failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,195 @@
+#include <stdio.h>
+#include "event_monitor.h"
+#include "gpio_hal.h"
+#include "rtos_api.h"
+
+// Built with -DEVENT_MONITOR_STATIC_MASK=0x2D (see README)
+#ifndef EVENT_MONITOR_STATIC_MASK
+#error "test_static_mask.c must be built with EVENT_MONITOR_STATIC_MASK"
+#endif
+
+// Mock state and test tracking
+static gpio_mask_t simulated_state = 0;
+static void (*static_callback)(gpio_mask_t new_state) = NULL;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Last values handed to the HAL and the report function
+static gpio_mask_t interrupt_mask = 0;
+static uint32_t reported_events = 0;
+
+// Mocks for HAL functions
+gpio_mask_t gpio_read_input(void) {
+    return simulated_state;
+}
+
+void gpio_register_callback(void (*callback)(gpio_mask_t new_state)) {
+    static_callback = callback;
+}
+
+uint32_t gpio_read_timestamp(void) {
+    return 0;
+}
+
+void gpio_set_interrupt_mask(gpio_mask_t mask) {
+    interrupt_mask = mask;
+}
+
+// Mocks for RTOS functions
+void rtos_mutex_lock(void) {}
+void rtos_mutex_unlock(void) {}
+void rtos_task_delay_ms(uint32_t ms) { (void)ms; }
+void rtos_task_create(rtos_task_t* task, void (*task_fn)(void*), void* arg) {
+    (void)task; (void)task_fn; (void)arg;
+}
+
+void report_event_count(uint32_t count) {
+    reported_events = count;
+}
+
+void check_test_result(const char* test_name, uint32_t expected, uint32_t actual) {
+    printf("  %s: Expected %u, Actual %u -> ", test_name, expected, actual);
+    if (expected == actual) {
+        printf("PASS\n");
+        tests_passed++;
+    } else {
+        printf("FAIL\n");
+        tests_failed++;
+    }
+}
+
+// Helper function to simulate GPIO changes
+void simulate_gpio_change(gpio_mask_t new_state) {
+    simulated_state = new_state;
+    if (static_callback) {
+        static_callback(new_state);
+    }
+}
+
+// Generic formula and bit loop, as in the runtime-mask build
+static uint32_t reference_edges(gpio_mask_t previous, gpio_mask_t next, gpio_mask_t mask) {
+    gpio_mask_t rising = (~previous & next) & mask;
+    uint32_t count = 0;
+    int i;
+
+    for (i = 0; i < 32; ++i) {
+        if (rising & (1u << i)) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+void test_fixed_mask() {
+    printf("\n1. Testing the compile-time mask...\n");
+
+    // The argument is ignored in favour of the build-time mask
+    event_monitor_init(0xFFFFFFFF);
+    check_test_result("Mask fixed at build time", EVENT_MONITOR_STATIC_MASK, event_monitor_get_mask());
+    check_test_result("Interrupts for fixed mask", EVENT_MONITOR_STATIC_MASK, interrupt_mask);
+
+    event_monitor_set_mask(0x01);
+    check_test_result("Mask updates ignored", EVENT_MONITOR_STATIC_MASK, event_monitor_get_mask());
+}
+
+void test_matches_generic() {
+    gpio_mask_t previous = 0;
+    gpio_mask_t next;
+    uint32_t seed = 12345;
+    uint32_t expected = 0;
+    uint32_t window;
+    uint32_t i;
+
+    printf("\n2. Testing counts against the generic formula...\n");
+
+    simulate_gpio_change(0);
+    event_monitor_report_window();
+
+    for (window = 0; window < 4; ++window) {
+        expected = 0;
+        for (i = 0; i < 10000; ++i) {
+            // Random states, with more single-pin changes than multi-pin ones
+            seed = seed * 1103515245u + 12345u;
+            next = (seed & 0x100) ? previous ^ (1u << ((seed >> 16) & 31)) : (seed >> 3) ^ (seed << 13);
+            expected += reference_edges(previous, next, EVENT_MONITOR_STATIC_MASK);
+            simulate_gpio_change(next);
+            previous = next;
+        }
+        event_monitor_report_window();
+        check_test_result("Window count matches", expected, reported_events);
+    }
+}
+
+void test_batch_matches_generic() {
+    static gpio_mask_t states[256];
+    gpio_mask_t previous = simulated_state;
+    uint32_t expected = 0;
+    uint32_t i;
+
+    printf("\n3. Testing batch counts against the generic formula...\n");
+
+    for (i = 0; i < 256; ++i) {
+        states[i] = i * 0x01010101u;
+        expected += reference_edges(previous, states[i], EVENT_MONITOR_STATIC_MASK);
+        previous = states[i];
+    }
+    event_monitor_process_batch(states, NULL, 256);
+
+    event_monitor_report_window();
+    check_test_result("Batch count matches", expected, reported_events);
+}
+
+void test_gates() {
+    printf("\n4. Testing gates in the static build...\n");
+
+    simulate_gpio_change(0);
+    event_monitor_report_window();
+
+    // Pin 0 counts only while pin 4 (unmonitored) is high
+    check_test_result("Gate set", 0, event_monitor_set_gate(0, 4, 1));
+    simulate_gpio_change(0x01);
+    simulate_gpio_change(0x00);
+    simulate_gpio_change(0x10);
+    simulate_gpio_change(0x11);
+    simulate_gpio_change(0x14);
+    event_monitor_report_window();
+    check_test_result("Closed gate blocks pin 0", 2, reported_events);
+
+    // Without gates the callback is back to the ungated count
+    event_monitor_clear_gate(0);
+    simulate_gpio_change(0x00);
+    simulate_gpio_change(0x01);
+    event_monitor_report_window();
+    check_test_result("Cleared gate counts pin 0", 1, reported_events);
+}
+
+void print_test_summary() {
+    int total_tests = tests_passed + tests_failed;
+
+    printf("\n----------------------------------------\n");
+    printf("TEST SUMMARY\n");
+    printf("----------------------------------------\n");
+    printf("Total tests run: %d\n", total_tests);
+    printf("Tests passed:    %d\n", tests_passed);
+    printf("Tests failed:    %d\n", tests_failed);
+
+    if (tests_failed == 0) {
+        printf("\nALL TESTS PASSED!\n");
+    } else {
+        printf("\nSOME TESTS FAILED!\n");
+    }
+}
+
+int main() {
+    printf("\nStarting Static Mask Unit Tests\n");
+    printf("========================================\n");
+
+    test_fixed_mask();
+    test_matches_generic();
+    test_batch_matches_generic();
+    test_gates();
+
+    print_test_summary();
+
+    return (tests_failed == 0) ? 0 : 1;
+}
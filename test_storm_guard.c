@@ -0,0 +1,234 @@
+#include <stdio.h>
+#include "event_monitor.h"
+#include "storm_guard.h"
+#include "gpio_hal.h"
+#include "rtos_api.h"
+
+// Mock state and test tracking
+static gpio_mask_t simulated_state = 0;
+static uint32_t simulated_time = 0;
+static void (*static_callback)(gpio_mask_t new_state) = NULL;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Last values handed to the HAL and the report sinks
+static gpio_mask_t interrupt_mask = 0;
+static gpio_mask_t reported_polled = 0;
+static uint32_t reported_storms = 0;
+static uint32_t reported_events = 0;
+
+// Mocks for HAL functions
+gpio_mask_t gpio_read_input(void) {
+    return simulated_state;
+}
+
+void gpio_register_callback(void (*callback)(gpio_mask_t new_state)) {
+    static_callback = callback;
+}
+
+uint32_t gpio_read_timestamp(void) {
+    return simulated_time;
+}
+
+void gpio_set_interrupt_mask(gpio_mask_t mask) {
+    interrupt_mask = mask;
+}
+
+// Mocks for RTOS functions
+void rtos_mutex_lock(void) {}
+void rtos_mutex_unlock(void) {}
+void rtos_task_delay_ms(uint32_t ms) { (void)ms; }
+void rtos_task_create(rtos_task_t* task, void (*task_fn)(void*), void* arg) {
+    (void)task; (void)task_fn; (void)arg;
+}
+
+void report_event_count(uint32_t count) {
+    reported_events = count;
+}
+
+static void report_storms(gpio_mask_t polled_pins, uint32_t storms) {
+    reported_polled = polled_pins;
+    reported_storms = storms;
+}
+
+// Helper function to simulate GPIO changes at a given time
+void simulate_gpio_change(uint32_t time, gpio_mask_t new_state) {
+    simulated_time = time;
+    simulated_state = new_state;
+    if (static_callback) {
+        static_callback(new_state);
+    }
+}
+
+void check_test_result(const char* test_name, uint32_t expected, uint32_t actual) {
+    printf("  %s: Expected %u, Actual %u -> ", test_name, expected, actual);
+    if (expected == actual) {
+        printf("PASS\n");
+        tests_passed++;
+    } else {
+        printf("FAIL\n");
+        tests_failed++;
+    }
+}
+
+// Changes the port without an interrupt, as a masked pin does
+static void set_masked_state(gpio_mask_t new_state) {
+    simulated_state = new_state;
+}
+
+static void poll_times(uint32_t polls) {
+    while (polls--) {
+        storm_guard_poll();
+    }
+}
+
+void test_storm_detection() {
+    uint32_t i;
+
+    printf("\n1. Testing storm detection and masking...\n");
+
+    simulated_state = 0;
+    event_monitor_init(0x05);
+    check_test_result("Guard started", 0, (uint32_t)storm_guard_init(4, 1000, 1, report_storms));
+    check_test_result("All interrupts enabled", 0x05, interrupt_mask);
+
+    // Four changes in a slice are tolerated
+    for (i = 1; i <= 4; ++i) {
+        simulate_gpio_change(i * 10, (i & 1) << 2);
+    }
+    check_test_result("Below threshold", 0x05, interrupt_mask);
+
+    // A new slice starts the count again
+    simulate_gpio_change(2000, 0x04);
+    simulate_gpio_change(2010, 0x00);
+    check_test_result("Slice rolled over", 0x05, interrupt_mask);
+
+    for (i = 1; i <= 3; ++i) {
+        simulate_gpio_change(2010 + i, (i & 1) << 2);
+    }
+    check_test_result("Pin 2 masked on fifth change", 0x01, interrupt_mask);
+
+    event_monitor_report_window();
+    check_test_result("Edges before masking counted", 5, reported_events);
+    check_test_result("Storm reported", 1, reported_storms);
+    check_test_result("Pin 2 reported as polled", 0x04, reported_polled);
+}
+
+void test_polled_counting() {
+    printf("\n2. Testing polled counting while masked...\n");
+
+    // Pin 2 is high from the last interrupt; the poll sees it fall and rise
+    set_masked_state(0x00);
+    storm_guard_poll();
+    set_masked_state(0x04);
+    storm_guard_poll();
+
+    // A pulse between two polls is missed
+    set_masked_state(0x00);
+    set_masked_state(0x04);
+    storm_guard_poll();
+
+    // Another pin's interrupt sees the masked pin change first
+    set_masked_state(0x00);
+    simulate_gpio_change(3000, 0x05);
+    storm_guard_poll();
+
+    event_monitor_report_window();
+    check_test_result("Polled and interrupt edges counted once", 2, reported_events);
+    check_test_result("No new storms", 0, reported_storms);
+}
+
+void test_backoff() {
+    uint32_t i;
+
+    printf("\n3. Testing re-enable with backoff...\n");
+
+    // Four polls so far; the pin comes back after STORM_GUARD_MIN_BACKOFF
+    poll_times(STORM_GUARD_MIN_BACKOFF - 5);
+    check_test_result("Still masked", 0x01, interrupt_mask);
+    storm_guard_poll();
+    check_test_result("Re-enabled after backoff", 0x05, interrupt_mask);
+
+    // Storming again doubles the backoff
+    for (i = 1; i <= 5; ++i) {
+        simulate_gpio_change(5000 + i, 0x01 | ((~i & 1) << 2));
+    }
+    check_test_result("Masked again", 0x01, interrupt_mask);
+    poll_times(2 * STORM_GUARD_MIN_BACKOFF - 1);
+    check_test_result("Held for doubled backoff", 0x01, interrupt_mask);
+    storm_guard_poll();
+    check_test_result("Re-enabled after doubled backoff", 0x05, interrupt_mask);
+
+    // A quiet window resets the backoff
+    event_monitor_report_window();
+    check_test_result("Second storm reported", 1, reported_storms);
+    event_monitor_report_window();
+    check_test_result("Nothing polled", 0, reported_polled);
+    for (i = 1; i <= 5; ++i) {
+        simulate_gpio_change(9000 + i, 0x01 | ((i & 1) << 2));
+    }
+    check_test_result("Masked by third storm", 0x01, interrupt_mask);
+    poll_times(STORM_GUARD_MIN_BACKOFF);
+    check_test_result("Backoff back to minimum", 0x05, interrupt_mask);
+}
+
+void test_backoff_across_windows() {
+    uint32_t i;
+
+    printf("\n4. Testing backoff of a pin released mid-window...\n");
+
+    // The third storm's window closes; its release doubled the backoff
+    event_monitor_report_window();
+    for (i = 1; i <= 5; ++i) {
+        simulate_gpio_change(12000 + i, 0x01 | ((~i & 1) << 2));
+    }
+    check_test_result("Masked by fourth storm", 0x01, interrupt_mask);
+
+    // Still polled when its window closes, released in the next one
+    event_monitor_report_window();
+    check_test_result("Polled at window close", 0x04, reported_polled);
+    poll_times(2 * STORM_GUARD_MIN_BACKOFF);
+    check_test_result("Re-enabled mid-window", 0x05, interrupt_mask);
+    event_monitor_report_window();
+
+    // That window was not quiet, so the backoff doubles again
+    for (i = 1; i <= 5; ++i) {
+        simulate_gpio_change(14000 + i, 0x01 | ((i & 1) << 2));
+    }
+    check_test_result("Masked by fifth storm", 0x01, interrupt_mask);
+    poll_times(4 * STORM_GUARD_MIN_BACKOFF - 1);
+    check_test_result("Held for quadrupled backoff", 0x01, interrupt_mask);
+    storm_guard_poll();
+    check_test_result("Re-enabled after quadrupled backoff", 0x05, interrupt_mask);
+}
+
+void print_test_summary() {
+    int total_tests = tests_passed + tests_failed;
+
+    printf("\n----------------------------------------\n");
+    printf("TEST SUMMARY\n");
+    printf("----------------------------------------\n");
+    printf("Total tests run: %d\n", total_tests);
+    printf("Tests passed:    %d\n", tests_passed);
+    printf("Tests failed:    %d\n", tests_failed);
+
+    if (tests_failed == 0) {
+        printf("\nALL TESTS PASSED!\n");
+    } else {
+        printf("\nSOME TESTS FAILED!\n");
+    }
+}
+
+int main() {
+    printf("\nStarting Storm Guard Unit Tests\n");
+    printf("========================================\n");
+
+    test_storm_detection();
+    test_polled_counting();
+    test_backoff();
+    test_backoff_across_windows();
+
+    print_test_summary();
+
+    return (tests_failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,201 @@
+#include <stdio.h>
+#include "event_monitor.h"
+#include "subscribers.h"
+#include "gpio_hal.h"
+#include "rtos_api.h"
+
+// Mock state and test tracking
+static gpio_mask_t simulated_state = 0;
+static uint32_t simulated_time = 0;
+static void (*static_callback)(gpio_mask_t new_state) = NULL;
+static gpio_mask_t interrupt_mask = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Sink calls per subscriber id and the count of the last one
+static uint32_t sink_calls[SUBSCRIBERS_MAX];
+static uint32_t last_counts[SUBSCRIBERS_MAX];
+static uint32_t total_counts[SUBSCRIBERS_MAX];
+
+// Mocks for HAL functions
+gpio_mask_t gpio_read_input(void) {
+    return simulated_state;
+}
+
+void gpio_register_callback(void (*callback)(gpio_mask_t new_state)) {
+    static_callback = callback;
+}
+
+uint32_t gpio_read_timestamp(void) {
+    return simulated_time;
+}
+
+void gpio_set_interrupt_mask(gpio_mask_t mask) {
+    interrupt_mask = mask;
+}
+
+// Mocks for RTOS functions
+void rtos_mutex_lock(void) {}
+void rtos_mutex_unlock(void) {}
+void rtos_task_delay_ms(uint32_t ms) { (void)ms; }
+void rtos_task_create(rtos_task_t* task, void (*task_fn)(void*), void* arg) {
+    (void)task; (void)task_fn; (void)arg;
+}
+
+void report_event_count(uint32_t count) {
+    (void)count;
+}
+
+static void subscriber_sink(int id, uint32_t count) {
+    ++sink_calls[id];
+    last_counts[id] = count;
+    total_counts[id] += count;
+}
+
+static void reset_sinks(void) {
+    int i;
+
+    for (i = 0; i < SUBSCRIBERS_MAX; ++i) {
+        sink_calls[i] = 0;
+        last_counts[i] = 0;
+        total_counts[i] = 0;
+    }
+}
+
+// Helper function to simulate GPIO changes at a given time
+void simulate_gpio_change(uint32_t time, gpio_mask_t new_state) {
+    simulated_time = time;
+    simulated_state = new_state;
+    if (static_callback) {
+        static_callback(new_state);
+    }
+}
+
+// Advances the monitor task by the given number of ticks
+static void run_ticks(uint32_t ticks) {
+    while (ticks--) {
+        event_monitor_tick();
+    }
+}
+
+void check_test_result(const char* test_name, uint32_t expected, uint32_t actual) {
+    printf("  %s: Expected %u, Actual %u -> ", test_name, expected, actual);
+    if (expected == actual) {
+        printf("PASS\n");
+        tests_passed++;
+    } else {
+        printf("FAIL\n");
+        tests_failed++;
+    }
+}
+
+void test_independent_masks() {
+    int fast;
+    int slow;
+
+    printf("\n1. Testing independent masks and periods...\n");
+
+    simulated_state = 0;
+    event_monitor_init(0x00000001);
+    reset_sinks();
+
+    fast = subscriber_add(0x00000003, EVENT_MONITOR_TICK_MS, subscriber_sink);
+    slow = subscriber_add(0x00000300, EVENT_MONITOR_WINDOW_MS, subscriber_sink);
+    check_test_result("Fast subscriber added", 1, (uint32_t)(fast >= 0));
+    check_test_result("Slow subscriber added", 1, (uint32_t)(slow >= 0));
+    check_test_result("Unmonitored pins raise interrupts", 0x00000303, interrupt_mask);
+
+    simulate_gpio_change(1, 0x00000103);    // Both fast pins and one slow pin
+    run_ticks(1);
+    check_test_result("Fast reported after one tick", 1, sink_calls[fast]);
+    check_test_result("Fast count", 2, last_counts[fast]);
+    check_test_result("Slow not yet due", 0, sink_calls[slow]);
+
+    simulate_gpio_change(2, 0x00000000);
+    simulate_gpio_change(3, 0x00000201);    // One fast pin, other slow pin
+    run_ticks(EVENT_MONITOR_WINDOW_MS / EVENT_MONITOR_TICK_MS - 1);
+    check_test_result("Fast reported every tick", EVENT_MONITOR_WINDOW_MS / EVENT_MONITOR_TICK_MS, sink_calls[fast]);
+    check_test_result("Fast total", 3, total_counts[fast]);
+    check_test_result("Slow reported once", 1, sink_calls[slow]);
+    check_test_result("Slow count", 2, last_counts[slow]);
+
+    subscriber_remove(fast);
+    check_test_result("Removed pins unwatched", 0x00000301, interrupt_mask);
+    subscriber_remove(slow);
+    check_test_result("Only monitored pins left", 0x00000001, interrupt_mask);
+}
+
+void test_long_periods() {
+    int minute;
+    uint32_t ticks = 60000 / EVENT_MONITOR_TICK_MS;
+
+    printf("\n2. Testing periods longer than the wheel...\n");
+
+    reset_sinks();
+    minute = subscriber_add(0x00000010, 60000, subscriber_sink);
+    simulate_gpio_change(10, 0x00000010);
+    simulate_gpio_change(11, 0x00000000);
+    simulate_gpio_change(12, 0x00000010);
+
+    run_ticks(ticks - 1);
+    check_test_result("Not due before the minute", 0, sink_calls[minute]);
+    run_ticks(1);
+    check_test_result("Due on the minute", 1, sink_calls[minute]);
+    check_test_result("Minute count", 2, last_counts[minute]);
+    run_ticks(ticks);
+    check_test_result("Due again a minute later", 2, sink_calls[minute]);
+    check_test_result("Count reset", 0, last_counts[minute]);
+
+    subscriber_remove(minute);
+    run_ticks(ticks);
+    check_test_result("Removed subscriber not reported", 2, sink_calls[minute]);
+}
+
+void test_limits() {
+    int ids[SUBSCRIBERS_MAX];
+    int i;
+
+    printf("\n3. Testing subscriber limits...\n");
+
+    check_test_result("Zero period rejected", (uint32_t)-1, (uint32_t)subscriber_add(1, 0, subscriber_sink));
+    check_test_result("Partial tick rejected", (uint32_t)-1, (uint32_t)subscriber_add(1, EVENT_MONITOR_TICK_MS + 1, subscriber_sink));
+    check_test_result("Empty mask rejected", (uint32_t)-1, (uint32_t)subscriber_add(0, EVENT_MONITOR_TICK_MS, subscriber_sink));
+
+    for (i = 0; i < SUBSCRIBERS_MAX; ++i) {
+        ids[i] = subscriber_add(1u << i, EVENT_MONITOR_TICK_MS, subscriber_sink);
+    }
+    check_test_result("Full table accepted", 1, (uint32_t)(ids[SUBSCRIBERS_MAX - 1] >= 0));
+    check_test_result("Overflow rejected", (uint32_t)-1, (uint32_t)subscriber_add(1, EVENT_MONITOR_TICK_MS, subscriber_sink));
+    subscriber_remove(ids[0]);
+    check_test_result("Freed id reused", (uint32_t)ids[0], (uint32_t)subscriber_add(1, EVENT_MONITOR_TICK_MS, subscriber_sink));
+}
+
+void print_test_summary() {
+    int total_tests = tests_passed + tests_failed;
+
+    printf("\n----------------------------------------\n");
+    printf("TEST SUMMARY\n");
+    printf("----------------------------------------\n");
+    printf("Total tests run: %d\n", total_tests);
+    printf("Tests passed:    %d\n", tests_passed);
+    printf("Tests failed:    %d\n", tests_failed);
+
+    if (tests_failed == 0) {
+        printf("\nALL TESTS PASSED!\n");
+    } else {
+        printf("\nSOME TESTS FAILED!\n");
+    }
+}
+
+int main() {
+    printf("\nStarting Subscriber Unit Tests\n");
+    printf("========================================\n");
+
+    test_independent_masks();
+    test_long_periods();
+    test_limits();
+
+    print_test_summary();
+
+    return (tests_failed == 0) ? 0 : 1;
+}
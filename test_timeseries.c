@@ -0,0 +1,208 @@
+#include <stdio.h>
+#include "event_monitor.h"
+#include "timeseries.h"
+#include "gpio_hal.h"
+#include "rtos_api.h"
+
+// Mock state and test tracking
+static gpio_mask_t simulated_state = 0;
+static uint32_t simulated_time = 0;
+static void (*static_callback)(gpio_mask_t new_state) = NULL;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Rising edges per tick, as the reference for queries
+#define TICKS_RECORDED 400000
+static uint32_t tick_counts[TICKS_RECORDED];
+static uint32_t ticks_run = 0;
+
+// Mocks for HAL functions
+gpio_mask_t gpio_read_input(void) {
+    return simulated_state;
+}
+
+void gpio_register_callback(void (*callback)(gpio_mask_t new_state)) {
+    static_callback = callback;
+}
+
+uint32_t gpio_read_timestamp(void) {
+    return simulated_time;
+}
+
+void gpio_set_interrupt_mask(gpio_mask_t mask) {
+    (void)mask;
+}
+
+// Mocks for RTOS functions
+void rtos_mutex_lock(void) {}
+void rtos_mutex_unlock(void) {}
+void rtos_task_delay_ms(uint32_t ms) { (void)ms; }
+void rtos_task_create(rtos_task_t* task, void (*task_fn)(void*), void* arg) {
+    (void)task; (void)task_fn; (void)arg;
+}
+
+void report_event_count(uint32_t count) {
+    (void)count;
+}
+
+// Helper function to simulate GPIO changes at a given time
+void simulate_gpio_change(uint32_t time, gpio_mask_t new_state) {
+    simulated_time = time;
+    simulated_state = new_state;
+    if (static_callback) {
+        static_callback(new_state);
+    }
+}
+
+// Runs one monitor tick with the given number of pulses on pin 0
+static void run_tick(uint32_t pulses) {
+    uint32_t i;
+
+    for (i = 0; i < pulses; ++i) {
+        simulate_gpio_change(ticks_run, 0x00000001);
+        simulate_gpio_change(ticks_run, 0x00000000);
+    }
+    tick_counts[ticks_run++] = pulses;
+    event_monitor_tick();
+}
+
+// Sum of the recorded ticks in [from, to) ticks before now
+static uint32_t reference_count(uint32_t from_ago, uint32_t to_ago) {
+    uint32_t count = 0;
+    uint32_t t;
+
+    for (t = ticks_run - from_ago; t < ticks_run - to_ago; ++t) {
+        count += tick_counts[t];
+    }
+    return count;
+}
+
+void check_test_result(const char* test_name, uint32_t expected, uint32_t actual) {
+    printf("  %s: Expected %u, Actual %u -> ", test_name, expected, actual);
+    if (expected == actual) {
+        printf("PASS\n");
+        tests_passed++;
+    } else {
+        printf("FAIL\n");
+        tests_failed++;
+    }
+}
+
+void test_fine_ranges() {
+    timeseries_range_t range;
+    uint32_t t;
+
+    printf("\n1. Testing ranges at tick resolution...\n");
+
+    simulated_state = 0;
+    event_monitor_init(0x00000001);
+    check_test_result("Store initialized", 0, (uint32_t)timeseries_init());
+
+    timeseries_query(1000, 0, &range);
+    check_test_result("Empty store counts nothing", 0, range.count);
+    check_test_result("Empty range", 0, range.from_ago_ms - range.to_ago_ms);
+
+    for (t = 0; t < 25; ++t) {
+        run_tick(t % 4);
+    }
+
+    timeseries_query(5 * EVENT_MONITOR_TICK_MS, 0, &range);
+    check_test_result("Last five ticks", reference_count(5, 0), range.count);
+    check_test_result("Tick resolution", EVENT_MONITOR_TICK_MS, range.resolution_ms);
+
+    timeseries_query(3 * EVENT_MONITOR_TICK_MS + 1, EVENT_MONITOR_TICK_MS + 1, &range);
+    check_test_result("Range widened to whole ticks", reference_count(4, 1), range.count);
+    check_test_result("Widened start", 4 * EVENT_MONITOR_TICK_MS, range.from_ago_ms);
+    check_test_result("Widened end", EVENT_MONITOR_TICK_MS, range.to_ago_ms);
+
+    timeseries_query(3600000, 0, &range);
+    check_test_result("Range clipped to history", reference_count(25, 0), range.count);
+    check_test_result("Clipped start", 25 * EVENT_MONITOR_TICK_MS, range.from_ago_ms);
+
+    // The largest start asks for all history
+    timeseries_query(UINT32_MAX, 0, &range);
+    check_test_result("Maximum start counts all history", reference_count(25, 0), range.count);
+    check_test_result("Maximum start clipped", 25 * EVENT_MONITOR_TICK_MS, range.from_ago_ms);
+}
+
+void test_rollup() {
+    timeseries_range_t range;
+    uint32_t hour = 3600000 / EVENT_MONITOR_TICK_MS;
+    uint32_t t;
+
+    printf("\n2. Testing roll-up into coarser levels...\n");
+
+    timeseries_init();
+    ticks_run = 0;
+    for (t = 0; t < 3 * hour; ++t) {
+        run_tick((t / 7) % 3);
+    }
+
+    timeseries_query(3 * 3600000, 0, &range);
+    check_test_result("Three hours in total", reference_count(3 * hour, 0), range.count);
+    check_test_result("Hours used for the oldest part", 3600000, range.resolution_ms);
+
+    timeseries_query(60000, 0, &range);
+    check_test_result("Last minute from finer levels", reference_count(60000 / EVENT_MONITOR_TICK_MS, 0), range.count);
+    check_test_result("Seconds used within the last minute", 1000, range.resolution_ms);
+
+    timeseries_query(2 * 3600000 + 30 * 60000, 2 * 3600000, &range);
+    check_test_result("Old range widened to an hour", 3600000, range.from_ago_ms - range.to_ago_ms);
+    check_test_result("Old range count", reference_count(3 * hour, 2 * hour), range.count);
+}
+
+void test_against_reference() {
+    timeseries_range_t range;
+    uint32_t seed = 7;
+    uint32_t mismatches = 0;
+    uint32_t i;
+
+    printf("\n3. Testing random ranges against the tick record...\n");
+
+    for (i = 0; i < 2000; ++i) {
+        uint32_t a;
+        uint32_t b;
+
+        seed = seed * 1103515245u + 12345u;
+        a = (seed >> 8) % (ticks_run * EVENT_MONITOR_TICK_MS);
+        seed = seed * 1103515245u + 12345u;
+        b = (seed >> 8) % (ticks_run * EVENT_MONITOR_TICK_MS);
+        timeseries_query(a, b, &range);
+        if (range.count != reference_count(range.from_ago_ms / EVENT_MONITOR_TICK_MS,
+                                           range.to_ago_ms / EVENT_MONITOR_TICK_MS) ||
+            range.from_ago_ms < (a > b ? a : b) || range.to_ago_ms > (a < b ? a : b)) {
+            ++mismatches;
+        }
+    }
+    check_test_result("Ranges covered and counted exactly", 0, mismatches);
+}
+
+void print_test_summary() {
+    int total_tests = tests_passed + tests_failed;
+
+    printf("\n----------------------------------------\n");
+    printf("TEST SUMMARY\n");
+    printf("----------------------------------------\n");
+    printf("Total tests run: %d\n", total_tests);
+    printf("Tests passed:    %d\n", tests_passed);
+    printf("Tests failed:    %d\n", tests_failed);
+
+    if (tests_failed == 0) {
+        printf("\nALL TESTS PASSED!\n");
+    } else {
+        printf("\nSOME TESTS FAILED!\n");
+    }
+}
+
+int main() {
+    printf("\nStarting Time Series Unit Tests\n");
+    printf("========================================\n");
+
+    test_fine_ranges();
+    test_rollup();
+    test_against_reference();
+
+    print_test_summary();
+
+    return (tests_failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,236 @@
+#include <stdio.h>
+#include <string.h>
+#include "event_monitor.h"
+#include "gpio_hal.h"
+#include "gpio_trace.h"
+#include "gpio_trace_reader.h"
+#include "rtos_api.h"
+#include "trace_analysis.h"
+
+// Mock state and test tracking
+static gpio_mask_t simulated_state = 0;
+static uint32_t simulated_time = 0;
+static void (*static_callback)(gpio_mask_t new_state) = NULL;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Captured trace bytes
+static uint8_t trace_data[256 * 1024];
+static uint32_t trace_len = 0;
+
+// Mocks for HAL functions
+gpio_mask_t gpio_read_input(void) {
+    return simulated_state;
+}
+
+void gpio_register_callback(void (*callback)(gpio_mask_t new_state)) {
+    static_callback = callback;
+}
+
+uint32_t gpio_read_timestamp(void) {
+    return simulated_time;
+}
+
+void gpio_set_interrupt_mask(gpio_mask_t mask) {
+    (void)mask;
+}
+
+// Mocks for RTOS functions
+void rtos_mutex_lock(void) {}
+void rtos_mutex_unlock(void) {}
+void rtos_task_delay_ms(uint32_t ms) { (void)ms; }
+void rtos_task_create(rtos_task_t* task, void (*task_fn)(void*), void* arg) {
+    (void)task; (void)task_fn; (void)arg;
+}
+
+void report_event_count(uint32_t count) {
+    (void)count;
+}
+
+static void memory_sink(const uint8_t* data, uint32_t len, void* ctx) {
+    (void)ctx;
+    if (trace_len + len <= sizeof(trace_data)) {
+        memcpy(trace_data + trace_len, data, len);
+        trace_len += len;
+    }
+}
+
+void check_test_result(const char* test_name, uint32_t expected, uint32_t actual) {
+    printf("  %s: Expected %u, Actual %u -> ", test_name, expected, actual);
+    if (expected == actual) {
+        printf("PASS\n");
+        tests_passed++;
+    } else {
+        printf("FAIL\n");
+        tests_failed++;
+    }
+}
+
+// Records a pseudo-random trace, flushing every flush_every changes (0: never)
+static void record_trace(uint32_t changes, uint32_t flush_every) {
+    uint32_t seed = 12345;
+    uint32_t i;
+
+    trace_len = 0;
+    simulated_state = 0;
+    simulated_time = 0;
+    event_monitor_init(0xFF);
+    gpio_trace_start(0xFF, 1000, memory_sink, NULL);
+    for (i = 1; i <= changes; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        simulated_time += 1 + (seed >> 16) % 16;
+        simulated_state ^= 1u << ((seed >> 8) % 8);
+        static_callback(simulated_state);
+        if (flush_every && i % flush_every == 0) {
+            gpio_trace_flush();
+        }
+    }
+    gpio_trace_stop();
+}
+
+// Sequential reference: decode every block in order, counting rising edges on
+// records and across gaps left by dropped records
+static void reference_counts(gpio_mask_t mask, uint64_t window_ticks, uint64_t* total, uint64_t* pin0,
+                             uint64_t* window0) {
+    gpio_trace_header_t header;
+    gpio_trace_block_t block;
+    gpio_trace_cursor_t cursor;
+    gpio_trace_record_t record;
+    gpio_mask_t state = 0;
+    uint64_t start = 0;
+    size_t offset;
+    int first = 1;
+
+    *total = *pin0 = *window0 = 0;
+    gpio_trace_read_header(trace_data, trace_len, &header, &offset);
+    while (gpio_trace_read_block(trace_data, trace_len, &offset, &block) == 1) {
+        gpio_mask_t rising;
+        if (first) {
+            state = block.base_state;
+            start = block.base_timestamp;
+            first = 0;
+        }
+        rising = ~state & block.base_state & mask;
+        state = block.base_state;
+        gpio_trace_cursor_init(&cursor, &block);
+        do {
+            uint64_t time = block.base_timestamp;
+            while (rising) {
+                ++*total;
+                *pin0 += rising & 1u;
+                *window0 += (time - start) < window_ticks;
+                rising &= rising - 1;
+            }
+            if (gpio_trace_cursor_next(&cursor, &record) != 1) {
+                break;
+            }
+            rising = ~state & record.state & mask;
+            state = record.state;
+            block.base_timestamp = record.timestamp;
+        } while (1);
+    }
+}
+
+static void check_analysis(const char* label, unsigned threads, uint32_t blocks_per_chunk) {
+    trace_analysis_config_t config;
+    trace_analysis_result_t result;
+    uint64_t total;
+    uint64_t pin0;
+    uint64_t window0;
+    uint64_t window_sum = 0;
+    size_t i;
+    char name[96];
+
+    config.mask = 0x5F;
+    config.window_ticks = 500;
+    config.threads = threads;
+    config.blocks_per_chunk = blocks_per_chunk;
+    reference_counts(config.mask, config.window_ticks, &total, &pin0, &window0);
+
+    snprintf(name, sizeof(name), "%s status", label);
+    check_test_result(name, 0, (uint32_t)trace_analyze(trace_data, trace_len, &config, &result));
+    for (i = 0; i < result.window_count; ++i) {
+        window_sum += result.window_counts[i];
+    }
+    snprintf(name, sizeof(name), "%s total edges", label);
+    check_test_result(name, (uint32_t)total, (uint32_t)result.total_edges);
+    snprintf(name, sizeof(name), "%s pin 0 edges", label);
+    check_test_result(name, (uint32_t)pin0, (uint32_t)result.pin_counts[0]);
+    snprintf(name, sizeof(name), "%s first window", label);
+    check_test_result(name, (uint32_t)window0, result.window_count ? (uint32_t)result.window_counts[0] : 0);
+    snprintf(name, sizeof(name), "%s window sum", label);
+    check_test_result(name, (uint32_t)total, (uint32_t)window_sum);
+    trace_analysis_free(&result);
+}
+
+void test_chunked_matches_sequential() {
+    printf("\n1. Testing chunked analysis against a sequential scan...\n");
+
+    record_trace(20000, 100);
+    check_analysis("1 thread, 1 block chunks", 1, 1);
+    check_analysis("4 threads, 1 block chunks", 4, 1);
+    check_analysis("3 threads, 7 block chunks", 3, 7);
+}
+
+void test_gaps_are_stitched() {
+    trace_analysis_config_t config;
+    trace_analysis_result_t result;
+
+    printf("\n2. Testing stitching across records lost while recording...\n");
+
+    // Rare flushes: the double buffer overruns and blocks start after gaps
+    record_trace(20000, 900);
+    check_test_result("Records were dropped", 1, gpio_trace_dropped() > 0);
+
+    config.mask = 0xFF;
+    config.window_ticks = 500;
+    config.threads = 4;
+    config.blocks_per_chunk = 1;
+    trace_analyze(trace_data, trace_len, &config, &result);
+    check_test_result("Gaps detected", 1, result.gaps > 0);
+    check_test_result("Dropped total", gpio_trace_dropped(), (uint32_t)result.dropped);
+    trace_analysis_free(&result);
+
+    check_analysis("4 threads with gaps", 4, 1);
+    check_analysis("2 threads with gaps", 2, 3);
+}
+
+void test_trailing_drop_block() {
+    printf("\n3. Testing a trailing drop block inside a multi-block chunk...\n");
+
+    // Never flushed: the stop block holds no records, only the state after the drops
+    record_trace(20000, 0);
+    check_test_result("Records were dropped", 1, gpio_trace_dropped() > 0);
+    check_analysis("1 thread, 3 block chunks", 1, 3);
+    check_analysis("2 threads, 3 block chunks", 2, 3);
+}
+
+void print_test_summary() {
+    int total_tests = tests_passed + tests_failed;
+
+    printf("\n----------------------------------------\n");
+    printf("TEST SUMMARY\n");
+    printf("----------------------------------------\n");
+    printf("Total tests run: %d\n", total_tests);
+    printf("Tests passed:    %d\n", tests_passed);
+    printf("Tests failed:    %d\n", tests_failed);
+
+    if (tests_failed == 0) {
+        printf("\nALL TESTS PASSED!\n");
+    } else {
+        printf("\nSOME TESTS FAILED!\n");
+    }
+}
+
+int main() {
+    printf("\nStarting Trace Analysis Unit Tests\n");
+    printf("========================================\n");
+
+    test_chunked_matches_sequential();
+    test_gaps_are_stitched();
+    test_trailing_drop_block();
+
+    print_test_summary();
+
+    return (tests_failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,271 @@
+#include <stdio.h>
+#include <string.h>
+#include "event_monitor.h"
+#include "gpio_hal.h"
+#include "gpio_trace.h"
+#include "gpio_trace_reader.h"
+#include "rtos_api.h"
+#include "trace_index.h"
+
+// Mock state and test tracking
+static gpio_mask_t simulated_state = 0;
+static uint32_t simulated_time = 0;
+static void (*static_callback)(gpio_mask_t new_state) = NULL;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Captured trace and index bytes
+static uint8_t trace_data[256 * 1024];
+static uint32_t trace_len = 0;
+static uint8_t index_data[64 * 1024];
+static uint32_t index_len = 0;
+
+// Mocks for HAL functions
+gpio_mask_t gpio_read_input(void) {
+    return simulated_state;
+}
+
+void gpio_register_callback(void (*callback)(gpio_mask_t new_state)) {
+    static_callback = callback;
+}
+
+uint32_t gpio_read_timestamp(void) {
+    return simulated_time;
+}
+
+void gpio_set_interrupt_mask(gpio_mask_t mask) {
+    (void)mask;
+}
+
+// Mocks for RTOS functions
+void rtos_mutex_lock(void) {}
+void rtos_mutex_unlock(void) {}
+void rtos_task_delay_ms(uint32_t ms) { (void)ms; }
+void rtos_task_create(rtos_task_t* task, void (*task_fn)(void*), void* arg) {
+    (void)task; (void)task_fn; (void)arg;
+}
+
+void report_event_count(uint32_t count) {
+    (void)count;
+}
+
+static void trace_sink(const uint8_t* data, uint32_t len, void* ctx) {
+    (void)ctx;
+    if (trace_len + len <= sizeof(trace_data)) {
+        memcpy(trace_data + trace_len, data, len);
+        trace_len += len;
+    }
+}
+
+static void index_sink(const uint8_t* data, uint32_t len, void* ctx) {
+    (void)ctx;
+    if (index_len + len <= sizeof(index_data)) {
+        memcpy(index_data + index_len, data, len);
+        index_len += len;
+    }
+}
+
+void check_test_result(const char* test_name, uint32_t expected, uint32_t actual) {
+    printf("  %s: Expected %u, Actual %u -> ", test_name, expected, actual);
+    if (expected == actual) {
+        printf("PASS\n");
+        tests_passed++;
+    } else {
+        printf("FAIL\n");
+        tests_failed++;
+    }
+}
+
+// Records a pseudo-random trace, flushing every flush_every changes
+static void record_trace(uint32_t changes, uint32_t flush_every) {
+    uint32_t seed = 777;
+    uint32_t i;
+
+    trace_len = 0;
+    simulated_state = 0;
+    simulated_time = 0;
+    event_monitor_init(0xFF);
+    gpio_trace_start(0xFF, 1000, trace_sink, NULL);
+    for (i = 1; i <= changes; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        simulated_time += 1 + (seed >> 16) % 8;
+        simulated_state ^= 1u << ((seed >> 8) % 8);
+        static_callback(simulated_state);
+        if (i % flush_every == 0) {
+            gpio_trace_flush();
+        }
+    }
+    gpio_trace_stop();
+}
+
+// Brute-force count of rising edges on pin with from <= time < to
+static uint64_t scan_count(int pin, uint64_t from, uint64_t to) {
+    gpio_trace_header_t header;
+    gpio_trace_block_t block;
+    gpio_trace_cursor_t cursor;
+    gpio_trace_record_t record;
+    gpio_mask_t bit = 1u << pin;
+    gpio_mask_t state = 0;
+    uint64_t count = 0;
+    size_t offset;
+    int first = 1;
+
+    gpio_trace_read_header(trace_data, trace_len, &header, &offset);
+    while (gpio_trace_read_block(trace_data, trace_len, &offset, &block) == 1) {
+        if (first) {
+            state = block.base_state;
+            first = 0;
+        }
+        if (!(state & bit) && (block.base_state & bit) &&
+            block.base_timestamp >= from && block.base_timestamp < to) {
+            ++count;
+        }
+        state = block.base_state;
+        gpio_trace_cursor_init(&cursor, &block);
+        while (gpio_trace_cursor_next(&cursor, &record) == 1) {
+            if (!(state & bit) && (record.state & bit) && record.timestamp >= from && record.timestamp < to) {
+                ++count;
+            }
+            state = record.state;
+        }
+    }
+    return count;
+}
+
+static uint64_t read_u64(const uint8_t* p) {
+    uint64_t v = 0;
+    int i;
+
+    for (i = 7; i >= 0; --i) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+static void check_random_queries(const char* label, uint32_t blocks_per_entry) {
+    trace_index_t index;
+    uint64_t counts[32];
+    uint32_t seed = 99;
+    uint32_t mismatches = 0;
+    uint32_t i;
+    char name[96];
+
+    index_len = 0;
+    snprintf(name, sizeof(name), "%s build", label);
+    check_test_result(name, 0, (uint32_t)trace_index_build(trace_data, trace_len, blocks_per_entry, index_sink, NULL));
+    snprintf(name, sizeof(name), "%s open", label);
+    check_test_result(name, 0, (uint32_t)trace_index_open(&index, index_data, index_len, trace_data, trace_len));
+
+    for (i = 0; i < 200; ++i) {
+        uint64_t from;
+        uint64_t to;
+        int pin;
+        seed = seed * 1103515245u + 12345u;
+        from = (seed >> 8) % (simulated_time + 100);
+        seed = seed * 1103515245u + 12345u;
+        to = from + (seed >> 8) % 20000;
+        pin = (int)(seed % 8);
+        trace_index_query(&index, from, to, counts);
+        if (counts[pin] != scan_count(pin, from, to)) {
+            ++mismatches;
+        }
+    }
+    snprintf(name, sizeof(name), "%s query mismatches", label);
+    check_test_result(name, 0, mismatches);
+}
+
+void test_queries_match_scan() {
+    printf("\n1. Testing range queries against a full scan...\n");
+
+    record_trace(30000, 100);
+    check_random_queries("1 block per entry", 1);
+    check_random_queries("8 blocks per entry", 8);
+    check_random_queries("1000 blocks per entry", 1000);
+}
+
+void test_queries_across_gaps() {
+    printf("\n2. Testing range queries across lost records...\n");
+
+    record_trace(30000, 900);
+    check_test_result("Records were dropped", 1, gpio_trace_dropped() > 0);
+    check_random_queries("Gaps, 1 block per entry", 1);
+    check_random_queries("Gaps, 4 blocks per entry", 4);
+}
+
+void test_index_mismatch() {
+    trace_index_t index;
+
+    printf("\n3. Testing index validation...\n");
+
+    record_trace(1000, 100);
+    index_len = 0;
+    trace_index_build(trace_data, trace_len, 8, index_sink, NULL);
+    check_test_result("Index for another trace rejected", (uint32_t)-1,
+                      (uint32_t)trace_index_open(&index, index_data, index_len, trace_data, trace_len - 1));
+}
+
+void test_rewritten_trace() {
+    trace_index_t index;
+    uint64_t counts[32];
+    const uint8_t* entry;
+    uint64_t middle;
+    size_t offset;
+
+    printf("\n4. Testing traces rewritten at the same size...\n");
+
+    record_trace(30000, 100);
+    index_len = 0;
+    trace_index_build(trace_data, trace_len, 1, index_sink, NULL);
+
+    // A different tail is caught when the index is opened
+    trace_data[trace_len - 1] ^= 0x01;
+    check_test_result("Changed tail rejected", (uint32_t)-1,
+                      (uint32_t)trace_index_open(&index, index_data, index_len, trace_data, trace_len));
+    trace_data[trace_len - 1] ^= 0x01;
+    check_test_result("Restored trace accepted", 0,
+                      (uint32_t)trace_index_open(&index, index_data, index_len, trace_data, trace_len));
+
+    // A changed block in the middle fails the queries that decode it
+    entry = index_data + TRACE_INDEX_HEADER_SIZE + (size_t)(index.entry_count / 2) * TRACE_INDEX_ENTRY_SIZE;
+    offset = (size_t)read_u64(entry);
+    middle = read_u64(entry + 8) + 1;
+    check_test_result("Middle block outside the checksum", 1,
+                      offset > TRACE_INDEX_CHECK_BYTES && offset + TRACE_INDEX_CHECK_BYTES < trace_len);
+    trace_data[offset + 8] ^= 0x01; // Base timestamp
+    check_test_result("Changed middle block fails the query", (uint32_t)-1,
+                      (uint32_t)trace_index_query(&index, 0, middle, counts));
+    trace_data[offset + 8] ^= 0x01;
+    check_test_result("Restored block queries again", 0,
+                      (uint32_t)trace_index_query(&index, 0, middle, counts));
+}
+
+void print_test_summary() {
+    int total_tests = tests_passed + tests_failed;
+
+    printf("\n----------------------------------------\n");
+    printf("TEST SUMMARY\n");
+    printf("----------------------------------------\n");
+    printf("Total tests run: %d\n", total_tests);
+    printf("Tests passed:    %d\n", tests_passed);
+    printf("Tests failed:    %d\n", tests_failed);
+
+    if (tests_failed == 0) {
+        printf("\nALL TESTS PASSED!\n");
+    } else {
+        printf("\nSOME TESTS FAILED!\n");
+    }
+}
+
+int main() {
+    printf("\nStarting Trace Index Unit Tests\n");
+    printf("========================================\n");
+
+    test_queries_match_scan();
+    test_queries_across_gaps();
+    test_index_mismatch();
+    test_rewritten_trace();
+
+    print_test_summary();
+
+    return (tests_failed == 0) ? 0 : 1;
+}
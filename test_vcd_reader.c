@@ -0,0 +1,263 @@
+#include <stdio.h>
+#include <string.h>
+#include "vcd_reader.h"
+#include "vcd_writer.h"
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Captured snapshots
+static uint64_t snapshot_times[64];
+static gpio_mask_t snapshot_states[64];
+static uint32_t snapshot_count = 0;
+
+static vcd_reader_t reader;
+static vcd_writer_t writer;
+
+// Writer output for the round-trip test
+static char vcd_text[64 * 1024];
+static uint32_t vcd_len = 0;
+
+static const char capture[] =
+    "$date today $end\n"
+    "$version logic analyzer $end\n"
+    "$timescale 10us $end\n"
+    "$scope module top $end\n"
+    "$scope module io $end\n"
+    "$var wire 1 ! door $end\n"
+    "$var wire 1 % flow $end\n"
+    "$var wire 4 #a bus [3:0] $end\n"
+    "$var wire 1 q spi_cs $end\n"
+    "$upscope $end\n"
+    "$upscope $end\n"
+    "$enddefinitions $end\n"
+    "$comment initial values follow $end\n"
+    "#0\n"
+    "$dumpvars\n"
+    "x!\n"
+    "0%\n"
+    "b0000 #a\n"
+    "1q\n"
+    "$end\n"
+    "#3\n"
+    "1!\n"
+    "0q\n"
+    "#5\n"
+    "1q\n"
+    "#9\n"
+    "b1010 #a\n"
+    "1%\n"
+    "z!\n";
+
+static void record_snapshot(void* ctx, uint64_t time, gpio_mask_t state) {
+    (void)ctx;
+    if (snapshot_count < 64) {
+        snapshot_times[snapshot_count] = time;
+        snapshot_states[snapshot_count] = state;
+    }
+    ++snapshot_count;
+}
+
+static void text_sink(const uint8_t* data, uint32_t len, void* ctx) {
+    (void)ctx;
+    if (vcd_len + len <= sizeof(vcd_text)) {
+        memcpy(vcd_text + vcd_len, data, len);
+        vcd_len += len;
+    }
+}
+
+void check_test_result(const char* test_name, uint32_t expected, uint32_t actual) {
+    printf("  %s: Expected %u, Actual %u -> ", test_name, expected, actual);
+    if (expected == actual) {
+        printf("PASS\n");
+        tests_passed++;
+    } else {
+        printf("FAIL\n");
+        tests_failed++;
+    }
+}
+
+// Maps door to bit 0, flow to bit 5 and the 4-bit bus to bits 8..11
+static void parse_capture(size_t chunk_size) {
+    size_t len = sizeof(capture) - 1;
+    size_t i;
+
+    snapshot_count = 0;
+    vcd_reader_init(&reader, record_snapshot, NULL);
+    vcd_reader_map(&reader, "door", 0);
+    vcd_reader_map(&reader, "top.io.flow", 5);
+    vcd_reader_map(&reader, "bus", 8);
+    for (i = 0; i < len; i += chunk_size) {
+        vcd_reader_feed(&reader, capture + i, len - i < chunk_size ? len - i : chunk_size);
+    }
+    vcd_reader_finish(&reader);
+}
+
+static void check_capture(const char* label) {
+    char name[96];
+
+    snprintf(name, sizeof(name), "%s snapshot count", label);
+    // #0 initial, #3 door rises, #5 only unmapped spi_cs, #9 bus and flow change
+    check_test_result(name, 3, snapshot_count);
+    snprintf(name, sizeof(name), "%s mapped mask", label);
+    check_test_result(name, 0xF21, reader.mapped_mask);
+    snprintf(name, sizeof(name), "%s timescale is 10 us", label);
+    check_test_result(name, 1, reader.timescale_fs == 10000000000ull);
+    snprintf(name, sizeof(name), "%s initial state", label);
+    check_test_result(name, 0x000, snapshot_states[0]);
+    snprintf(name, sizeof(name), "%s state at #3", label);
+    check_test_result(name, 0x001, snapshot_states[1]);
+    snprintf(name, sizeof(name), "%s time of last snapshot", label);
+    check_test_result(name, 9, (uint32_t)snapshot_times[2]);
+    snprintf(name, sizeof(name), "%s state at #9", label);
+    check_test_result(name, 0xA20, snapshot_states[2]);
+}
+
+void test_named_mapping() {
+    printf("\n1. Testing named signal mapping...\n");
+
+    parse_capture(sizeof(capture));
+    check_capture("Whole file");
+}
+
+void test_split_chunks() {
+    printf("\n2. Testing tokens split across chunks...\n");
+
+    parse_capture(1);
+    check_capture("1-byte chunks");
+    parse_capture(7);
+    check_capture("7-byte chunks");
+}
+
+void test_writer_round_trip() {
+    static const gpio_mask_t states[] = { 0x3, 0x1, 0x9, 0x8, 0xC };
+    uint32_t mismatches = 0;
+    uint32_t i;
+
+    printf("\n3. Testing round trip through the VCD writer...\n");
+
+    vcd_len = 0;
+    vcd_writer_begin(&writer, 0x0F, 1000000, NULL, 0, 0x0, text_sink, NULL);
+    for (i = 0; i < 5; ++i) {
+        vcd_writer_change(&writer, (i + 1) * 100, states[i]);
+    }
+    vcd_writer_end(&writer);
+
+    snapshot_count = 0;
+    vcd_reader_init(&reader, record_snapshot, NULL);
+    vcd_reader_feed(&reader, vcd_text, vcd_len);
+    vcd_reader_finish(&reader);
+
+    check_test_result("Snapshots", 6, snapshot_count);
+    check_test_result("Auto-mapped mask", 0x0F, reader.mapped_mask);
+    check_test_result("Timescale is 1 us", 1, reader.timescale_fs == 1000000000ull);
+    for (i = 0; i < 5; ++i) {
+        if (snapshot_times[i + 1] != (i + 1) * 100 || snapshot_states[i + 1] != states[i]) {
+            ++mismatches;
+        }
+    }
+    check_test_result("Snapshot mismatches", 0, mismatches);
+}
+
+void test_wide_vector() {
+    static const char wide[] =
+        "$timescale 1ns $end\n"
+        "$var wire 40 w data [39:0] $end\n"
+        "$enddefinitions $end\n"
+        "#0\n"
+        "b0 w\n"
+        "#1\n"
+        "b1111111110000000000000000000000000000001 w\n";
+
+    printf("\n4. Testing vectors wider than 32 bits...\n");
+
+    snapshot_count = 0;
+    vcd_reader_init(&reader, record_snapshot, NULL);
+    vcd_reader_map(&reader, "data", 0);
+    vcd_reader_feed(&reader, wide, sizeof(wide) - 1);
+    vcd_reader_finish(&reader);
+
+    check_test_result("Wide vector snapshots", 2, snapshot_count);
+    check_test_result("Low 32 bits kept", 0x80000001, snapshot_states[1]);
+}
+
+void test_split_wide_vector() {
+    static const char head[] =
+        "$timescale 1ns $end\n"
+        "$var wire 200 w data [199:0] $end\n"
+        "$enddefinitions $end\n"
+        "#0\n"
+        "b0 w\n"
+        "#1\n"
+        "b";
+    static const char low[] = "10000000000000000000000000000011";
+    char text[512];
+    size_t len;
+    size_t offset;
+    size_t i;
+
+    printf("\n5. Testing a split vector wider than the token buffer...\n");
+
+    // 200 digits; the low 32 come last
+    len = sizeof(head) - 1;
+    memcpy(text, head, len);
+    for (i = 0; i < 168; ++i) {
+        text[len++] = i < 8 ? '1' : '0';
+    }
+    memcpy(text + len, low, sizeof(low) - 1);
+    len += sizeof(low) - 1;
+    memcpy(text + len, " w\n", 3);
+    len += 3;
+
+    // Split right after the 'b', so the digits arrive in one piece
+    snapshot_count = 0;
+    vcd_reader_init(&reader, record_snapshot, NULL);
+    vcd_reader_map(&reader, "data", 0);
+    vcd_reader_feed(&reader, text, sizeof(head) - 1);
+    vcd_reader_feed(&reader, text + sizeof(head) - 1, len - (sizeof(head) - 1));
+    vcd_reader_finish(&reader);
+    check_test_result("Split after the b", 0x80000003, snapshot_states[1]);
+
+    // Small chunks, so the digits accumulate across many pieces
+    snapshot_count = 0;
+    vcd_reader_init(&reader, record_snapshot, NULL);
+    vcd_reader_map(&reader, "data", 0);
+    for (offset = 0; offset < len; offset += 7) {
+        vcd_reader_feed(&reader, text + offset, len - offset < 7 ? len - offset : 7);
+    }
+    vcd_reader_finish(&reader);
+    check_test_result("Split in small chunks", 0x80000003, snapshot_states[1]);
+    check_test_result("Split vector snapshots", 2, snapshot_count);
+}
+
+void print_test_summary() {
+    int total_tests = tests_passed + tests_failed;
+
+    printf("\n----------------------------------------\n");
+    printf("TEST SUMMARY\n");
+    printf("----------------------------------------\n");
+    printf("Total tests run: %d\n", total_tests);
+    printf("Tests passed:    %d\n", tests_passed);
+    printf("Tests failed:    %d\n", tests_failed);
+
+    if (tests_failed == 0) {
+        printf("\nALL TESTS PASSED!\n");
+    } else {
+        printf("\nSOME TESTS FAILED!\n");
+    }
+}
+
+int main() {
+    printf("\nStarting VCD Reader Unit Tests\n");
+    printf("========================================\n");
+
+    test_named_mapping();
+    test_split_chunks();
+    test_writer_round_trip();
+    test_wide_vector();
+    test_split_wide_vector();
+
+    print_test_summary();
+
+    return (tests_failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,147 @@
+#include <stdio.h>
+#include <string.h>
+#include "vcd_writer.h"
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Captured VCD text
+static char output[8192];
+static uint32_t output_len = 0;
+static uint32_t sink_calls = 0;
+
+static vcd_writer_t writer;
+
+static void memory_sink(const uint8_t* data, uint32_t len, void* ctx) {
+    (void)ctx;
+    ++sink_calls;
+    if (output_len + len < sizeof(output)) {
+        memcpy(output + output_len, data, len);
+        output_len += len;
+        output[output_len] = '\0';
+    }
+}
+
+static void reset_output(void) {
+    output_len = 0;
+    output[0] = '\0';
+    sink_calls = 0;
+}
+
+void check_test_result(const char* test_name, uint32_t expected, uint32_t actual) {
+    printf("  %s: Expected %u, Actual %u -> ", test_name, expected, actual);
+    if (expected == actual) {
+        printf("PASS\n");
+        tests_passed++;
+    } else {
+        printf("FAIL\n");
+        tests_failed++;
+    }
+}
+
+void test_changed_bits_only() {
+    static const char* const names[32] = { "door", 0, "flow" };
+    static const char expected[] =
+        "$version event_monitor GPIO export $end\n"
+        "$timescale 1 us $end\n"
+        "$scope module gpio $end\n"
+        "$var wire 1 ! door $end\n"
+        "$var wire 1 # flow $end\n"
+        "$var wire 1 $ pin3 $end\n"
+        "$upscope $end\n"
+        "$enddefinitions $end\n"
+        "#0\n"
+        "$dumpvars\n"
+        "1!\n"
+        "0#\n"
+        "0$\n"
+        "$end\n"
+        "#5\n"
+        "1#\n"
+        "#7\n"
+        "0!\n"
+        "1$\n";
+
+    printf("\n1. Testing that only changed monitored bits are written...\n");
+
+    reset_output();
+    vcd_writer_begin(&writer, 0x0D, 1000000, names, 100, 0x01, memory_sink, NULL);
+    vcd_writer_change(&writer, 105, 0x05);   // Bit 2 rises
+    vcd_writer_change(&writer, 106, 0x07);   // Bit 1 is not monitored: nothing written
+    vcd_writer_change(&writer, 107, 0x0E);   // Bit 0 falls, bit 3 rises
+    vcd_writer_end(&writer);
+
+    check_test_result("Output matches", 1, strcmp(output, expected) == 0);
+    if (strcmp(output, expected) != 0) {
+        printf("%s", output);
+    }
+}
+
+void test_timescale() {
+    printf("\n2. Testing timescale selection...\n");
+
+    reset_output();
+    vcd_writer_begin(&writer, 0x01, 1000, NULL, 0, 0, memory_sink, NULL);
+    vcd_writer_end(&writer);
+    check_test_result("1 kHz uses 1 ms", 1, strstr(output, "$timescale 1 ms $end") != NULL);
+
+    reset_output();
+    vcd_writer_begin(&writer, 0x01, 100000000, NULL, 0, 0, memory_sink, NULL);
+    vcd_writer_change(&writer, 3, 1);
+    vcd_writer_end(&writer);
+    check_test_result("100 MHz uses 10 ns", 1, strstr(output, "$timescale 10 ns $end") != NULL);
+    check_test_result("100 MHz tick scaling", 1, strstr(output, "#3\n1!") != NULL);
+
+    reset_output();
+    vcd_writer_begin(&writer, 0x01, 32768, NULL, 0, 0, memory_sink, NULL);
+    vcd_writer_change(&writer, 32768 * 3 + 1, 1);
+    vcd_writer_end(&writer);
+    check_test_result("32768 Hz rounds to ns", 1, strstr(output, "$timescale 1 ns $end") != NULL);
+    check_test_result("32768 Hz tick scaling", 1, strstr(output, "#3000030517\n") != NULL);
+}
+
+void test_bounded_buffer() {
+    uint32_t i;
+
+    printf("\n3. Testing fixed-size output buffering...\n");
+
+    reset_output();
+    vcd_writer_begin(&writer, 0x01, 1000, NULL, 0, 0, memory_sink, NULL);
+    for (i = 1; i <= 600; ++i) {
+        vcd_writer_change(&writer, i, i & 1);
+    }
+    vcd_writer_end(&writer);
+
+    check_test_result("Output split into several writes", 1, sink_calls > 1);
+    check_test_result("Last change written", 1, strstr(output, "#600\n0!\n") != NULL);
+}
+
+void print_test_summary() {
+    int total_tests = tests_passed + tests_failed;
+
+    printf("\n----------------------------------------\n");
+    printf("TEST SUMMARY\n");
+    printf("----------------------------------------\n");
+    printf("Total tests run: %d\n", total_tests);
+    printf("Tests passed:    %d\n", tests_passed);
+    printf("Tests failed:    %d\n", tests_failed);
+
+    if (tests_failed == 0) {
+        printf("\nALL TESTS PASSED!\n");
+    } else {
+        printf("\nSOME TESTS FAILED!\n");
+    }
+}
+
+int main() {
+    printf("\nStarting VCD Writer Unit Tests\n");
+    printf("========================================\n");
+
+    test_changed_bits_only();
+    test_timescale();
+    test_bounded_buffer();
+
+    print_test_summary();
+
+    return (tests_failed == 0) ? 0 : 1;
+}
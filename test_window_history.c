@@ -0,0 +1,179 @@
+#include <stdio.h>
+#include "event_monitor.h"
+#include "window_history.h"
+#include "gpio_hal.h"
+#include "rtos_api.h"
+
+// Mock state and test tracking
+static gpio_mask_t simulated_state = 0;
+static uint32_t simulated_time = 0;
+static void (*static_callback)(gpio_mask_t new_state) = NULL;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Mocks for HAL functions
+gpio_mask_t gpio_read_input(void) {
+    return simulated_state;
+}
+
+void gpio_register_callback(void (*callback)(gpio_mask_t new_state)) {
+    static_callback = callback;
+}
+
+uint32_t gpio_read_timestamp(void) {
+    return simulated_time;
+}
+
+void gpio_set_interrupt_mask(gpio_mask_t mask) {
+    (void)mask;
+}
+
+// Mocks for RTOS functions
+void rtos_mutex_lock(void) {}
+void rtos_mutex_unlock(void) {}
+void rtos_task_delay_ms(uint32_t ms) { (void)ms; }
+void rtos_task_create(rtos_task_t* task, void (*task_fn)(void*), void* arg) {
+    (void)task; (void)task_fn; (void)arg;
+}
+
+void report_event_count(uint32_t count) {
+    (void)count;
+}
+
+// Helper function to simulate GPIO changes at a given time
+void simulate_gpio_change(uint32_t time, gpio_mask_t new_state) {
+    simulated_time = time;
+    simulated_state = new_state;
+    if (static_callback) {
+        static_callback(new_state);
+    }
+}
+
+// Closes a window with the given pulses on pins 1 and 4
+static void run_window(uint32_t pulses_1, uint32_t pulses_4) {
+    uint32_t i;
+
+    for (i = 0; i < pulses_1 || i < pulses_4; ++i) {
+        simulate_gpio_change(i, (i < pulses_1 ? 0x02u : 0u) | (i < pulses_4 ? 0x10u : 0u));
+        simulate_gpio_change(i, 0x00000000);
+    }
+    event_monitor_report_window();
+}
+
+void check_test_result(const char* test_name, uint32_t expected, uint32_t actual) {
+    printf("  %s: Expected %u, Actual %u -> ", test_name, expected, actual);
+    if (expected == actual) {
+        printf("PASS\n");
+        tests_passed++;
+    } else {
+        printf("FAIL\n");
+        tests_failed++;
+    }
+}
+
+void test_window_stats() {
+    static const uint32_t pulses[] = { 5, 1, 9, 3, 7 };
+    window_stats_t stats;
+    unsigned i;
+
+    printf("\n1. Testing statistics over recent windows...\n");
+
+    simulated_state = 0;
+    event_monitor_init(0xFFFFFFFF);
+    check_test_result("History initialized", 0, (uint32_t)window_history_init(0x00000012));
+    check_test_result("No window yet", (uint32_t)-1, (uint32_t)window_history_stats(1, 4, 50, &stats));
+
+    for (i = 0; i < 5; ++i) {
+        run_window(pulses[i], 2);
+    }
+    check_test_result("Windows recorded", 5, window_history_count());
+
+    window_history_stats(1, 4, 50, &stats);
+    check_test_result("Last four windows", 4, stats.windows);
+    check_test_result("Min", 1, stats.min);
+    check_test_result("Max", 9, stats.max);
+    check_test_result("Sum", 20, stats.sum);
+    check_test_result("Mean", 5, stats.mean);
+    check_test_result("Median", 3, stats.percentile);
+
+    window_history_stats(1, 10, 100, &stats);
+    check_test_result("Capped at the recorded windows", 5, stats.windows);
+    check_test_result("100th percentile is the max", 9, stats.percentile);
+
+    window_history_stats(4, 3, 90, &stats);
+    check_test_result("Second pin kept apart", 2, stats.max);
+
+    window_history_stats(WINDOW_HISTORY_ALL, 1, 0, &stats);
+    check_test_result("Aggregate of the last window", 9, stats.sum);
+}
+
+void test_wraparound() {
+    window_stats_t stats;
+    uint32_t i;
+
+    printf("\n2. Testing ring wraparound and saturation...\n");
+
+    for (i = 0; i < WINDOW_HISTORY_DEPTH + 3; ++i) {
+        run_window(i, 0);
+    }
+    window_history_stats(1, WINDOW_HISTORY_DEPTH + 10, 0, &stats);
+    check_test_result("Depth windows kept", WINDOW_HISTORY_DEPTH, stats.windows);
+    check_test_result("Oldest windows dropped", 3, stats.min);
+    check_test_result("Newest window kept", WINDOW_HISTORY_DEPTH + 2, stats.max);
+
+    run_window(70000, 0);
+    window_history_stats(1, 1, 50, &stats);
+    check_test_result("Pin count saturates", 0xFFFF, stats.max);
+    window_history_stats(WINDOW_HISTORY_ALL, 1, 50, &stats);
+    check_test_result("Aggregate does not", 70000, stats.max);
+}
+
+void test_limits() {
+    window_stats_t stats;
+
+    printf("\n3. Testing history limits...\n");
+
+    check_test_result("Unrecorded pin rejected", (uint32_t)-1, (uint32_t)window_history_stats(2, 4, 50, &stats));
+    check_test_result("Bad percentile rejected", (uint32_t)-1, (uint32_t)window_history_stats(1, 4, 101, &stats));
+    check_test_result("Too many pins rejected", (uint32_t)-1, (uint32_t)window_history_init(0x1FF));
+
+    // Re-init to other pins starts an empty history
+    check_test_result("Re-initialized", 0, (uint32_t)window_history_init(0x00000010));
+    check_test_result("History reset", 0, window_history_count());
+    check_test_result("Dropped pin rejected", (uint32_t)-1, (uint32_t)window_history_stats(1, 4, 50, &stats));
+    run_window(3, 6);
+    window_history_stats(4, 4, 50, &stats);
+    check_test_result("Pin 4 now at rank 0", 6, stats.max);
+    window_history_stats(WINDOW_HISTORY_ALL, 4, 50, &stats);
+    check_test_result("Aggregate of the new pins only", 6, stats.sum);
+}
+
+void print_test_summary() {
+    int total_tests = tests_passed + tests_failed;
+
+    printf("\n----------------------------------------\n");
+    printf("TEST SUMMARY\n");
+    printf("----------------------------------------\n");
+    printf("Total tests run: %d\n", total_tests);
+    printf("Tests passed:    %d\n", tests_passed);
+    printf("Tests failed:    %d\n", tests_failed);
+
+    if (tests_failed == 0) {
+        printf("\nALL TESTS PASSED!\n");
+    } else {
+        printf("\nSOME TESTS FAILED!\n");
+    }
+}
+
+int main() {
+    printf("\nStarting Window History Unit Tests\n");
+    printf("========================================\n");
+
+    test_window_stats();
+    test_wraparound();
+    test_limits();
+
+    print_test_summary();
+
+    return (tests_failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,161 @@
+#include <stddef.h>
+#include "timeseries.h"
+#include "pin_bits.h"
+#include "rtos_api.h"
+
+#define LEVELS 4
+
+typedef struct {
+    uint32_t* buckets;  // Ring in the arena
+    uint32_t depth;
+    uint32_t span;      // Ticks per bucket
+    uint32_t written;   // Buckets completed since init
+    uint32_t partial;   // Sum of the finer buckets of the bucket in progress
+} level_t;
+
+static uint32_t arena[TIMESERIES_DEPTH_0 + TIMESERIES_DEPTH_1 + TIMESERIES_DEPTH_2 + TIMESERIES_DEPTH_3];
+static level_t levels[LEVELS];
+static volatile uint32_t tick_count = 0;
+
+static void timeseries_on_change(const event_change_t* change);
+static void timeseries_on_tick(void);
+
+static const event_observer_t timeseries_observer = {
+    timeseries_on_change,
+    NULL,
+    timeseries_on_tick
+};
+
+static void timeseries_on_change(const event_change_t* change) {
+    if (change->rising_edges) {
+        rtos_mutex_lock();
+        tick_count += pin_bits_count(change->rising_edges);
+        rtos_mutex_unlock();
+    }
+}
+
+// Appends a tick bucket and rolls completed buckets up; called under the lock
+static void append(uint32_t count) {
+    level_t* level = levels;
+    level_t* next;
+
+    while (1) {
+        level->buckets[level->written % level->depth] = count;
+        ++level->written;
+        if (level == &levels[LEVELS - 1]) {
+            break;
+        }
+
+        next = level + 1;
+        next->partial += count;
+        if (level->written % (next->span / level->span) != 0) {
+            break;
+        }
+        count = next->partial;
+        next->partial = 0;
+        level = next;
+    }
+}
+
+static void timeseries_on_tick(void) {
+    rtos_mutex_lock();
+    append(tick_count);
+    tick_count = 0;
+    rtos_mutex_unlock();
+}
+
+void timeseries_query(uint32_t from_ago_ms, uint32_t to_ago_ms, timeseries_range_t* range) {
+    uint32_t now;
+    uint32_t from;
+    uint32_t to;
+    uint32_t upper;
+    uint32_t counted_from = 0;
+    uint32_t counted_to = 0;
+    uint32_t count = 0;
+    uint32_t resolution = 0;
+    int L;
+
+    if (from_ago_ms < to_ago_ms) {
+        uint32_t swap = from_ago_ms;
+        from_ago_ms = to_ago_ms;
+        to_ago_ms = swap;
+    }
+
+    rtos_mutex_lock();
+    // Work in ticks since init, widening the range to whole ticks; rounding
+    // up by remainder keeps from_ago_ms near UINT32_MAX from wrapping
+    now = levels[0].written;
+    from_ago_ms = from_ago_ms / EVENT_MONITOR_TICK_MS + (from_ago_ms % EVENT_MONITOR_TICK_MS != 0);
+    to_ago_ms /= EVENT_MONITOR_TICK_MS;
+    from = from_ago_ms < now ? now - from_ago_ms : 0;
+    to = to_ago_ms < now ? now - to_ago_ms : 0;
+
+    // Each level serves the time from its oldest bucket that starts a bucket
+    // of the next level up to where the finer level took over
+    upper = now;
+    for (L = 0; L < LEVELS && upper > from; ++L) {
+        const level_t* level = &levels[L];
+        uint32_t oldest = level->written > level->depth ? level->written - level->depth : 0;
+        uint32_t lower = oldest * level->span;
+        uint32_t first;
+        uint32_t end;
+        uint32_t k;
+
+        if (L + 1 < LEVELS) {
+            uint32_t coarse = levels[L + 1].span;
+            lower = (lower + coarse - 1) / coarse * coarse;
+        }
+
+        first = (lower > from ? lower : from) / level->span;
+        end = (to + level->span - 1) / level->span;
+        if (end > upper / level->span) {
+            end = upper / level->span;
+        }
+        if (first < end) {
+            for (k = first; k < end; ++k) {
+                count += level->buckets[k % level->depth];
+            }
+            if (counted_to == 0) {
+                counted_to = end * level->span;
+            }
+            counted_from = first * level->span;
+            resolution = level->span;
+        }
+        upper = lower;
+    }
+    rtos_mutex_unlock();
+
+    range->count = count;
+    range->from_ago_ms = counted_to ? (now - counted_from) * EVENT_MONITOR_TICK_MS : 0;
+    range->to_ago_ms = counted_to ? (now - counted_to) * EVENT_MONITOR_TICK_MS : 0;
+    range->resolution_ms = resolution * EVENT_MONITOR_TICK_MS;
+}
+
+int timeseries_init(void) {
+    static const uint32_t depths[LEVELS] = {
+        TIMESERIES_DEPTH_0, TIMESERIES_DEPTH_1, TIMESERIES_DEPTH_2, TIMESERIES_DEPTH_3
+    };
+    static const uint32_t ratios[LEVELS] = {
+        1, TIMESERIES_RATIO_1, TIMESERIES_RATIO_2, TIMESERIES_RATIO_3
+    };
+    uint32_t* buckets = arena;
+    uint32_t span = 1;
+    int L;
+
+    event_monitor_remove_observer(&timeseries_observer);
+
+    rtos_mutex_lock();
+    for (L = 0; L < LEVELS; ++L) {
+        span *= ratios[L];
+        levels[L].buckets = buckets;
+        levels[L].depth = depths[L];
+        levels[L].span = span;
+        levels[L].written = 0;
+        levels[L].partial = 0;
+        buckets += depths[L];
+    }
+    tick_count = 0;
+    rtos_mutex_unlock();
+
+    return event_monitor_add_observer(&timeseries_observer);
+}
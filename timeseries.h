@@ -0,0 +1,65 @@
+#ifndef TIMESERIES_H
+#define TIMESERIES_H
+
+#include <stdint.h>
+#include "event_monitor.h"
+
+// Fixed-memory history of the aggregate rising-edge count at four
+// resolutions: one monitor tick (EVENT_MONITOR_TICK_MS, 100 ms by default),
+// 1 s, 1 min and 1 h. Every level is a ring in one static arena; each
+// completed bucket of a coarser level is the sum of the finer buckets it
+// spans, so recent history is fine-grained and old history coarse.
+
+// Finer buckets per bucket of levels 1, 2 and 3
+#ifndef TIMESERIES_RATIO_1
+#define TIMESERIES_RATIO_1 (1000 / EVENT_MONITOR_TICK_MS)
+#endif
+#ifndef TIMESERIES_RATIO_2
+#define TIMESERIES_RATIO_2 60
+#endif
+#ifndef TIMESERIES_RATIO_3
+#define TIMESERIES_RATIO_3 60
+#endif
+
+// Buckets kept per level; the defaults keep 10 s of ticks, 2 min of seconds,
+// 2 h of minutes and 2 days of hours in 1.5 KB
+#ifndef TIMESERIES_DEPTH_0
+#define TIMESERIES_DEPTH_0 100
+#endif
+#ifndef TIMESERIES_DEPTH_1
+#define TIMESERIES_DEPTH_1 120
+#endif
+#ifndef TIMESERIES_DEPTH_2
+#define TIMESERIES_DEPTH_2 120
+#endif
+#ifndef TIMESERIES_DEPTH_3
+#define TIMESERIES_DEPTH_3 48
+#endif
+
+// A level must hold at least one bucket of the next, so every point in
+// time stays covered while buckets move up
+#if TIMESERIES_DEPTH_0 < TIMESERIES_RATIO_1 || TIMESERIES_DEPTH_1 < TIMESERIES_RATIO_2 || \
+    TIMESERIES_DEPTH_2 < TIMESERIES_RATIO_3
+#error "TIMESERIES_DEPTH_n must be at least TIMESERIES_RATIO_(n+1)"
+#endif
+
+// Result of a query; the range is widened to whole buckets
+typedef struct {
+    uint32_t count;          // Rising edges in the range
+    uint32_t from_ago_ms;    // Start of the counted range, before now
+    uint32_t to_ago_ms;      // End of the counted range, before now
+    uint32_t resolution_ms;  // Coarsest bucket used
+} timeseries_range_t;
+
+// Clears the history and starts recording the count of monitored rising
+// edges every tick. Returns 0 on success, -1 if the observer table is full.
+int timeseries_init(void);
+
+// Counts the rising edges between from_ago_ms and to_ago_ms before the last
+// completed tick, using the finest level that still covers each part of
+// the range. History older than the coarsest level is left out, and the
+// returned range shows what was covered; an empty result has count 0 and
+// from_ago_ms == to_ago_ms.
+void timeseries_query(uint32_t from_ago_ms, uint32_t to_ago_ms, timeseries_range_t* range);
+
+#endif // TIMESERIES_H
@@ -0,0 +1,371 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "trace_analysis.h"
+#include "gpio_trace_reader.h"
+
+#define DEFAULT_BLOCKS_PER_CHUNK 256
+
+typedef struct {
+    size_t first_block;
+    size_t block_count;
+    gpio_mask_t start_state;     // State before the chunk's first record
+    gpio_mask_t end_state;       // State after its last record
+    uint64_t start_time;
+    uint64_t end_time;
+    uint64_t records;
+    uint64_t dropped;
+    uint64_t gaps;
+    uint64_t pin_counts[32];
+    uint64_t first_window;       // Window containing start_time
+    uint64_t* windows;           // Local histogram starting at first_window
+    size_t window_len;
+    size_t window_cap;
+    size_t window_index;         // Histogram slot of the current window
+    uint64_t window_limit;       // End time of the current window
+    int error;
+} chunk_t;
+
+// Chunks owned by one worker: the owner takes from head, thieves from tail
+typedef struct {
+    pthread_mutex_t lock;
+    size_t head;
+    size_t tail;
+} chunk_deque_t;
+
+typedef struct {
+    const uint8_t* data;
+    const gpio_trace_block_t* blocks;
+    chunk_t* chunks;
+    chunk_deque_t* deques;
+    unsigned workers;
+    gpio_mask_t mask;
+    uint64_t start_time;
+    uint64_t window_ticks;
+} analysis_t;
+
+typedef struct {
+    analysis_t* analysis;
+    unsigned id;
+} worker_t;
+
+static unsigned lowest_bit(gpio_mask_t bits) {
+    unsigned pin = 0;
+
+    while (!(bits & 1u)) {
+        bits >>= 1;
+        ++pin;
+    }
+    return pin;
+}
+
+// Adds edges to the chunk's histogram, growing it as time advances
+static int add_window_edges(const analysis_t* a, chunk_t* chunk, uint64_t time, uint64_t edges) {
+    uint64_t window;
+    size_t index;
+
+    // Records arrive in time order, so the window only changes at its limit
+    if (time >= chunk->window_limit || time + a->window_ticks < chunk->window_limit) {
+        window = (time - a->start_time) / a->window_ticks;
+        index = (size_t)(window - chunk->first_window);
+        if (index >= chunk->window_cap) {
+            size_t cap = chunk->window_cap ? chunk->window_cap : 16;
+            uint64_t* windows;
+            while (cap <= index) {
+                cap *= 2;
+            }
+            windows = realloc(chunk->windows, cap * sizeof(*windows));
+            if (windows == NULL) {
+                return -1;
+            }
+            memset(windows + chunk->window_cap, 0, (cap - chunk->window_cap) * sizeof(*windows));
+            chunk->windows = windows;
+            chunk->window_cap = cap;
+        }
+        if (index >= chunk->window_len) {
+            chunk->window_len = index + 1;
+        }
+        chunk->window_index = index;
+        chunk->window_limit = a->start_time + (window + 1) * a->window_ticks;
+    }
+    chunk->windows[chunk->window_index] += edges;
+    return 0;
+}
+
+static int count_rising(const analysis_t* a, chunk_t* chunk, gpio_mask_t previous, gpio_mask_t state, uint64_t time) {
+    gpio_mask_t rising = ~previous & state & a->mask;
+    uint64_t edges = 0;
+
+    while (rising) {
+        ++chunk->pin_counts[lowest_bit(rising)];
+        rising &= rising - 1;
+        ++edges;
+    }
+    return add_window_edges(a, chunk, time, edges);
+}
+
+static void analyze_chunk(const analysis_t* a, chunk_t* chunk) {
+    gpio_trace_cursor_t cursor;
+    gpio_trace_record_t record;
+    gpio_mask_t state;
+    size_t b;
+    int result;
+
+    state = a->blocks[chunk->first_block].base_state;
+    chunk->start_state = state;
+    chunk->start_time = a->blocks[chunk->first_block].base_timestamp;
+    chunk->end_time = chunk->start_time;
+    chunk->first_window = (chunk->start_time - a->start_time) / a->window_ticks;
+
+    for (b = chunk->first_block; b < chunk->first_block + chunk->block_count; ++b) {
+        const gpio_trace_block_t* block = &a->blocks[b];
+
+        chunk->dropped += block->dropped;
+        // Inside a chunk a state jump between blocks means lost records
+        if (block->base_state != state) {
+            ++chunk->gaps;
+            if (count_rising(a, chunk, state, block->base_state, block->base_timestamp) != 0) {
+                chunk->error = -2;
+                return;
+            }
+            state = block->base_state;
+            // A block without records still moves time on to its gap edges
+            if (block->base_timestamp > chunk->end_time) {
+                chunk->end_time = block->base_timestamp;
+            }
+        }
+
+        gpio_trace_cursor_init(&cursor, block);
+        while ((result = gpio_trace_cursor_next(&cursor, &record)) == 1) {
+            if (count_rising(a, chunk, state, record.state, record.timestamp) != 0) {
+                chunk->error = -2;
+                return;
+            }
+            state = record.state;
+            chunk->end_time = record.timestamp;
+            ++chunk->records;
+        }
+        if (result < 0) {
+            chunk->error = -1;
+            return;
+        }
+    }
+    chunk->end_state = state;
+}
+
+// Takes the next chunk from the worker's own deque, or steals one
+static int next_chunk(analysis_t* a, unsigned id, size_t* chunk) {
+    unsigned i;
+
+    chunk_deque_t* own = &a->deques[id];
+    pthread_mutex_lock(&own->lock);
+    if (own->head < own->tail) {
+        *chunk = own->head++;
+        pthread_mutex_unlock(&own->lock);
+        return 1;
+    }
+    pthread_mutex_unlock(&own->lock);
+
+    for (i = 1; i < a->workers; ++i) {
+        chunk_deque_t* victim = &a->deques[(id + i) % a->workers];
+        pthread_mutex_lock(&victim->lock);
+        if (victim->head < victim->tail) {
+            *chunk = --victim->tail;
+            pthread_mutex_unlock(&victim->lock);
+            return 1;
+        }
+        pthread_mutex_unlock(&victim->lock);
+    }
+    return 0;
+}
+
+static void* worker_main(void* arg) {
+    worker_t* worker = arg;
+    size_t chunk;
+
+    while (next_chunk(worker->analysis, worker->id, &chunk)) {
+        analyze_chunk(worker->analysis, &worker->analysis->chunks[chunk]);
+    }
+    return NULL;
+}
+
+// Collects the block headers; only the 24-byte headers are touched
+static int index_blocks(const uint8_t* data, size_t len, size_t offset,
+                        gpio_trace_block_t** blocks, size_t* count) {
+    gpio_trace_block_t block;
+    size_t cap = 0;
+    int result;
+
+    *blocks = NULL;
+    *count = 0;
+    while ((result = gpio_trace_read_block(data, len, &offset, &block)) == 1) {
+        if (*count == cap) {
+            gpio_trace_block_t* grown;
+            cap = cap ? cap * 2 : 1024;
+            grown = realloc(*blocks, cap * sizeof(*grown));
+            if (grown == NULL) {
+                return -2;
+            }
+            *blocks = grown;
+        }
+        (*blocks)[(*count)++] = block;
+    }
+    return result;
+}
+
+static void merge_chunk(trace_analysis_result_t* result, const chunk_t* chunk) {
+    size_t i;
+
+    result->records += chunk->records;
+    result->dropped += chunk->dropped;
+    result->gaps += chunk->gaps;
+    for (i = 0; i < 32; ++i) {
+        result->pin_counts[i] += chunk->pin_counts[i];
+        result->total_edges += chunk->pin_counts[i];
+    }
+    for (i = 0; i < chunk->window_len; ++i) {
+        result->window_counts[chunk->first_window + i] += chunk->windows[i];
+    }
+}
+
+int trace_analyze(const uint8_t* data, size_t len, const trace_analysis_config_t* config,
+                  trace_analysis_result_t* result) {
+    gpio_trace_header_t header;
+    gpio_trace_block_t* blocks;
+    analysis_t a;
+    worker_t* workers = NULL;
+    pthread_t* threads = NULL;
+    size_t block_count;
+    size_t chunk_count;
+    size_t per_chunk;
+    size_t offset;
+    size_t windows;
+    size_t c;
+    unsigned started = 0;
+    unsigned w;
+    int status;
+
+    memset(result, 0, sizeof(*result));
+    if (gpio_trace_read_header(data, len, &header, &offset) != 0 || config->window_ticks == 0) {
+        return -1;
+    }
+    status = index_blocks(data, len, offset, &blocks, &block_count);
+    if (status < 0) {
+        free(blocks);
+        return status;
+    }
+    if (block_count == 0) {
+        free(blocks);
+        return 0;
+    }
+
+    per_chunk = config->blocks_per_chunk ? config->blocks_per_chunk : DEFAULT_BLOCKS_PER_CHUNK;
+    chunk_count = (block_count + per_chunk - 1) / per_chunk;
+
+    a.data = data;
+    a.blocks = blocks;
+    a.mask = config->mask;
+    a.start_time = blocks[0].base_timestamp;
+    a.window_ticks = config->window_ticks;
+    a.workers = config->threads;
+    if (a.workers == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        a.workers = cpus > 0 ? (unsigned)cpus : 1;
+    }
+    if (a.workers > chunk_count) {
+        a.workers = (unsigned)chunk_count;
+    }
+
+    a.chunks = calloc(chunk_count, sizeof(*a.chunks));
+    a.deques = calloc(a.workers, sizeof(*a.deques));
+    workers = calloc(a.workers, sizeof(*workers));
+    threads = calloc(a.workers, sizeof(*threads));
+    status = (a.chunks && a.deques && workers && threads) ? 0 : -2;
+
+    if (status == 0) {
+        for (c = 0; c < chunk_count; ++c) {
+            a.chunks[c].first_block = c * per_chunk;
+            a.chunks[c].block_count = (c + 1 == chunk_count) ? block_count - c * per_chunk : per_chunk;
+        }
+        // Each worker starts on a contiguous range and steals when it runs dry
+        for (w = 0; w < a.workers; ++w) {
+            pthread_mutex_init(&a.deques[w].lock, NULL);
+            a.deques[w].head = chunk_count * w / a.workers;
+            a.deques[w].tail = chunk_count * (w + 1) / a.workers;
+            workers[w].analysis = &a;
+            workers[w].id = w;
+        }
+        // Worker 0 runs on the calling thread
+        for (w = 1; w < a.workers; ++w) {
+            if (pthread_create(&threads[w], NULL, worker_main, &workers[w]) != 0) {
+                break;
+            }
+            ++started;
+        }
+        worker_main(&workers[0]);
+        for (w = 1; w <= started; ++w) {
+            pthread_join(threads[w], NULL);
+        }
+        for (w = 0; w < a.workers; ++w) {
+            pthread_mutex_destroy(&a.deques[w].lock);
+        }
+        result->threads_used = started + 1;
+
+        for (c = 0; c < chunk_count && status == 0; ++c) {
+            status = a.chunks[c].error;
+        }
+    }
+
+    // Stitch chunk boundaries: an edge between the end of one chunk and the
+    // start of the next can only come from records lost in between
+    for (c = 1; c < chunk_count && status == 0; ++c) {
+        chunk_t* chunk = &a.chunks[c];
+        if (a.chunks[c - 1].end_state != chunk->start_state) {
+            ++chunk->gaps;
+            status = count_rising(&a, chunk, a.chunks[c - 1].end_state, chunk->start_state, chunk->start_time);
+            if (status != 0) {
+                status = -2;
+            }
+        }
+    }
+
+    if (status == 0) {
+        result->start_time = a.start_time;
+        for (c = 0; c < chunk_count; ++c) {
+            if (a.chunks[c].end_time > result->end_time) {
+                result->end_time = a.chunks[c].end_time;
+            }
+        }
+        windows = (size_t)((result->end_time - a.start_time) / a.window_ticks) + 1;
+        result->window_counts = calloc(windows, sizeof(*result->window_counts));
+        if (result->window_counts == NULL) {
+            status = -2;
+        } else {
+            result->window_count = windows;
+            for (c = 0; c < chunk_count; ++c) {
+                merge_chunk(result, &a.chunks[c]);
+            }
+        }
+    }
+
+    if (a.chunks) {
+        for (c = 0; c < chunk_count; ++c) {
+            free(a.chunks[c].windows);
+        }
+    }
+    free(a.chunks);
+    free(a.deques);
+    free(workers);
+    free(threads);
+    free(blocks);
+    return status;
+}
+
+void trace_analysis_free(trace_analysis_result_t* result) {
+    free(result->window_counts);
+    result->window_counts = NULL;
+    result->window_count = 0;
+}
@@ -0,0 +1,41 @@
+#ifndef TRACE_ANALYSIS_H
+#define TRACE_ANALYSIS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "gpio_hal.h"
+
+// Parallel rising-edge analysis of a recorded trace. The trace is split into
+// chunks of whole blocks that worker threads decode independently; the edges
+// hidden at chunk boundaries are recovered afterwards by stitching each
+// chunk's final state to the next chunk's starting state.
+
+typedef struct {
+    gpio_mask_t mask;            // Pins to count rising edges on
+    uint64_t window_ticks;       // Histogram window length in trace ticks
+    unsigned threads;            // Worker threads, 0 for one per online CPU
+    uint32_t blocks_per_chunk;   // Work unit size, 0 for the default
+} trace_analysis_config_t;
+
+typedef struct {
+    uint64_t records;
+    uint64_t dropped;            // Records lost while recording
+    uint64_t gaps;               // Discontinuities caused by lost records
+    uint64_t total_edges;
+    uint64_t pin_counts[32];     // Rising edges per pin
+    uint64_t start_time;         // Ticks
+    uint64_t end_time;
+    uint64_t* window_counts;     // Rising edges per window from start_time
+    size_t window_count;
+    unsigned threads_used;
+} trace_analysis_result_t;
+
+// Analyzes a trace held in memory. Returns 0 on success, -1 if the trace is
+// invalid or corrupt, -2 if memory or threads could not be allocated.
+int trace_analyze(const uint8_t* data, size_t len, const trace_analysis_config_t* config,
+                  trace_analysis_result_t* result);
+
+// Releases the window histogram of a result
+void trace_analysis_free(trace_analysis_result_t* result);
+
+#endif // TRACE_ANALYSIS_H
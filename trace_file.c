@@ -0,0 +1,53 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "trace_file.h"
+
+int trace_file_map(trace_file_t* file, const char* path) {
+    struct stat st;
+    void* data;
+    int fd;
+
+    file->data = NULL;
+    file->len = 0;
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return -1;
+    }
+    if (st.st_size == 0) {
+        close(fd);
+        errno = EINVAL;
+        return -1;
+    }
+    data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping stays valid after the descriptor is closed
+    close(fd);
+    if (data == MAP_FAILED) {
+        return -1;
+    }
+
+    file->data = data;
+    file->len = (size_t)st.st_size;
+    return 0;
+}
+
+void trace_file_advise_sequential(const trace_file_t* file) {
+    posix_madvise((void*)file->data, file->len, POSIX_MADV_SEQUENTIAL);
+}
+
+void trace_file_unmap(trace_file_t* file) {
+    if (file->data) {
+        munmap((void*)file->data, file->len);
+        file->data = NULL;
+        file->len = 0;
+    }
+}
@@ -0,0 +1,22 @@
+#ifndef TRACE_FILE_H
+#define TRACE_FILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Read-only memory mapping of a trace file for the host tools
+
+typedef struct {
+    const uint8_t* data;
+    size_t len;
+} trace_file_t;
+
+// Maps the whole file; returns 0 on success, -1 with errno set on failure
+int trace_file_map(trace_file_t* file, const char* path);
+
+// Hints that the mapping will be read front to back once
+void trace_file_advise_sequential(const trace_file_t* file);
+
+void trace_file_unmap(trace_file_t* file);
+
+#endif // TRACE_FILE_H
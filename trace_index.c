@@ -0,0 +1,235 @@
+#include <string.h>
+#include "trace_index.h"
+#include "gpio_trace_reader.h"
+
+static void put_u32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static void put_u64(uint8_t* p, uint64_t v) {
+    put_u32(p, (uint32_t)v);
+    put_u32(p + 4, (uint32_t)(v >> 32));
+}
+
+static uint32_t get_u32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint64_t get_u64(const uint8_t* p) {
+    return (uint64_t)get_u32(p) | ((uint64_t)get_u32(p + 4) << 32);
+}
+
+// FNV-1a over the head and tail of the trace: its header, and the last
+// blocks, whose timestamps differ between any two recordings
+static uint64_t trace_checksum(const uint8_t* trace, size_t trace_len) {
+    size_t head = trace_len < TRACE_INDEX_CHECK_BYTES ? trace_len : TRACE_INDEX_CHECK_BYTES;
+    uint64_t hash = 14695981039346656037ull;
+    size_t i;
+
+    for (i = 0; i < head; ++i) {
+        hash = (hash ^ trace[i]) * 1099511628211ull;
+    }
+    for (i = trace_len - head; i < trace_len; ++i) {
+        hash = (hash ^ trace[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+static void add_rising(uint64_t counts[32], gpio_mask_t rising) {
+    unsigned pin = 0;
+
+    while (rising) {
+        if (rising & 1u) {
+            ++counts[pin];
+        }
+        rising >>= 1;
+        ++pin;
+    }
+}
+
+int trace_index_build(const uint8_t* trace, size_t trace_len, uint32_t blocks_per_entry,
+                      gpio_trace_sink_t sink, void* ctx) {
+    uint8_t header[TRACE_INDEX_HEADER_SIZE];
+    uint8_t entry[TRACE_INDEX_ENTRY_SIZE];
+    uint64_t counts[32];
+    gpio_trace_header_t trace_header;
+    gpio_trace_block_t block;
+    gpio_trace_cursor_t cursor;
+    gpio_trace_record_t record;
+    gpio_mask_t state = 0;
+    uint64_t blocks = 0;
+    uint64_t b;
+    size_t first_offset;
+    size_t block_offset;
+    size_t offset;
+    int result;
+    int i;
+
+    if (blocks_per_entry == 0 || gpio_trace_read_header(trace, trace_len, &trace_header, &first_offset) != 0) {
+        return -1;
+    }
+
+    // Count blocks first so the header can go out before the entries
+    offset = first_offset;
+    while ((result = gpio_trace_read_block(trace, trace_len, &offset, &block)) == 1) {
+        ++blocks;
+    }
+    if (result < 0) {
+        return -1;
+    }
+
+    memcpy(header, TRACE_INDEX_MAGIC, 4);
+    put_u32(header + 4, TRACE_INDEX_VERSION);
+    put_u32(header + 8, blocks_per_entry);
+    put_u32(header + 12, trace_header.clock_hz);
+    put_u64(header + 16, (uint64_t)trace_len);
+    put_u64(header + 24, (blocks + blocks_per_entry - 1) / blocks_per_entry);
+    put_u64(header + 32, trace_checksum(trace, trace_len));
+    sink(header, sizeof(header), ctx);
+
+    memset(counts, 0, sizeof(counts));
+    offset = first_offset;
+    for (b = 0; b < blocks; ++b) {
+        block_offset = offset;
+        gpio_trace_read_block(trace, trace_len, &offset, &block);
+        if (b == 0) {
+            state = block.base_state;
+        }
+        // Edges across records lost before a block belong to its start time
+        add_rising(counts, ~state & block.base_state);
+        state = block.base_state;
+
+        if (b % blocks_per_entry == 0) {
+            uint64_t group = blocks - b < blocks_per_entry ? blocks - b : blocks_per_entry;
+            put_u64(entry, (uint64_t)block_offset);
+            put_u64(entry + 8, block.base_timestamp);
+            put_u32(entry + 16, block.base_state);
+            put_u32(entry + 20, (uint32_t)group);
+            for (i = 0; i < 32; ++i) {
+                put_u64(entry + 24 + i * 8, counts[i]);
+            }
+            sink(entry, sizeof(entry), ctx);
+        }
+
+        gpio_trace_cursor_init(&cursor, &block);
+        while ((result = gpio_trace_cursor_next(&cursor, &record)) == 1) {
+            add_rising(counts, ~state & record.state);
+            state = record.state;
+        }
+        if (result < 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int trace_index_open(trace_index_t* index, const uint8_t* data, size_t len,
+                     const uint8_t* trace, size_t trace_len) {
+    if (len < TRACE_INDEX_HEADER_SIZE || memcmp(data, TRACE_INDEX_MAGIC, 4) != 0 ||
+        get_u32(data + 4) != TRACE_INDEX_VERSION || get_u64(data + 16) != (uint64_t)trace_len ||
+        get_u64(data + 32) != trace_checksum(trace, trace_len)) {
+        return -1;
+    }
+    index->index = data;
+    index->trace = trace;
+    index->trace_len = trace_len;
+    index->blocks_per_entry = get_u32(data + 8);
+    index->clock_hz = get_u32(data + 12);
+    index->entry_count = get_u64(data + 24);
+    if ((len - TRACE_INDEX_HEADER_SIZE) / TRACE_INDEX_ENTRY_SIZE < index->entry_count) {
+        return -1;
+    }
+    return 0;
+}
+
+static const uint8_t* entry_at(const trace_index_t* index, uint64_t i) {
+    return index->index + TRACE_INDEX_HEADER_SIZE + (size_t)i * TRACE_INDEX_ENTRY_SIZE;
+}
+
+// Rising edges per pin with timestamp < time
+static int count_before(const trace_index_t* index, uint64_t time, uint64_t counts[32]) {
+    gpio_trace_block_t block;
+    gpio_trace_cursor_t cursor;
+    gpio_trace_record_t record;
+    const uint8_t* entry;
+    gpio_mask_t state;
+    size_t offset;
+    uint64_t lo = 0;
+    uint64_t hi = index->entry_count;
+    uint32_t blocks;
+    uint32_t b;
+    int result;
+    int i;
+
+    // Find the last group that starts before time; later groups hold no
+    // edge earlier than time
+    while (lo < hi) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        if (get_u64(entry_at(index, mid) + 8) < time) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == 0) {
+        memset(counts, 0, 32 * sizeof(uint64_t));
+        return 0;
+    }
+
+    entry = entry_at(index, lo - 1);
+    for (i = 0; i < 32; ++i) {
+        counts[i] = get_u64(entry + 24 + i * 8);
+    }
+    offset = (size_t)get_u64(entry);
+    state = get_u32(entry + 16);
+    blocks = get_u32(entry + 20);
+
+    // Decode the group up to the first record at or after time
+    for (b = 0; b < blocks; ++b) {
+        if (gpio_trace_read_block(index->trace, index->trace_len, &offset, &block) != 1) {
+            return -1;
+        }
+        // A group that no longer starts where it was indexed means the trace changed
+        if (b == 0 && (block.base_timestamp != get_u64(entry + 8) || block.base_state != state)) {
+            return -1;
+        }
+        if (block.base_timestamp >= time) {
+            return 0;
+        }
+        add_rising(counts, ~state & block.base_state);
+        state = block.base_state;
+
+        gpio_trace_cursor_init(&cursor, &block);
+        while ((result = gpio_trace_cursor_next(&cursor, &record)) == 1) {
+            if (record.timestamp >= time) {
+                return 0;
+            }
+            add_rising(counts, ~state & record.state);
+            state = record.state;
+        }
+        if (result < 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int trace_index_query(const trace_index_t* index, uint64_t from, uint64_t to, uint64_t counts[32]) {
+    uint64_t before[32];
+    int i;
+
+    if (to <= from) {
+        memset(counts, 0, 32 * sizeof(uint64_t));
+        return 0;
+    }
+    if (count_before(index, from, before) != 0 || count_before(index, to, counts) != 0) {
+        return -1;
+    }
+    for (i = 0; i < 32; ++i) {
+        counts[i] -= before[i];
+    }
+    return 0;
+}
@@ -0,0 +1,123 @@
+// Builds and queries the sidecar count index of a recorded GPIO trace.
+//
+//   trace_query build <trace> [blocks_per_entry]
+//   trace_query count <trace> <from_s> <to_s> [pin]
+//
+// build writes <trace>.idx. count prints the rising edges per monitored pin
+// (or only the given pin) between two times in seconds from the trace start.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gpio_trace_reader.h"
+#include "trace_file.h"
+#include "trace_index.h"
+
+static void file_sink(const uint8_t* data, uint32_t len, void* ctx) {
+    fwrite(data, 1, len, (FILE*)ctx);
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr, "usage: %s build <trace> [blocks_per_entry]\n", prog);
+    fprintf(stderr, "       %s count <trace> <from_s> <to_s> [pin]\n", prog);
+}
+
+static int build(const char* trace_path, uint32_t blocks_per_entry) {
+    trace_file_t trace;
+    char path[4096];
+    FILE* out;
+    int status;
+
+    if (trace_file_map(&trace, trace_path) != 0) {
+        perror(trace_path);
+        return 1;
+    }
+    snprintf(path, sizeof(path), "%s.idx", trace_path);
+    out = fopen(path, "wb");
+    if (out == NULL) {
+        perror(path);
+        trace_file_unmap(&trace);
+        return 1;
+    }
+    trace_file_advise_sequential(&trace);
+    status = trace_index_build(trace.data, trace.len, blocks_per_entry, file_sink, out);
+    if (fclose(out) != 0 || status != 0) {
+        fprintf(stderr, "%s: %s\n", status != 0 ? trace_path : path,
+                status != 0 ? "corrupt trace" : "write failed");
+        remove(path);
+        status = 1;
+    }
+    trace_file_unmap(&trace);
+    return status ? 1 : 0;
+}
+
+static int count(const char* trace_path, double from_s, double to_s, int pin) {
+    trace_file_t trace;
+    trace_file_t idx;
+    trace_index_t index;
+    gpio_trace_header_t header;
+    gpio_trace_block_t block;
+    uint64_t counts[32];
+    uint64_t start;
+    size_t offset;
+    char path[4096];
+    int i;
+
+    snprintf(path, sizeof(path), "%s.idx", trace_path);
+    if (trace_file_map(&trace, trace_path) != 0) {
+        perror(trace_path);
+        return 1;
+    }
+    if (trace_file_map(&idx, path) != 0) {
+        perror(path);
+        return 1;
+    }
+    if (gpio_trace_read_header(trace.data, trace.len, &header, &offset) != 0 ||
+        trace_index_open(&index, idx.data, idx.len, trace.data, trace.len) != 0) {
+        fprintf(stderr, "%s: index does not match the trace, rebuild it\n", path);
+        return 1;
+    }
+    if (gpio_trace_read_block(trace.data, trace.len, &offset, &block) != 1) {
+        fprintf(stderr, "%s: empty trace\n", trace_path);
+        return 1;
+    }
+    start = block.base_timestamp;
+
+    if (trace_index_query(&index, start + (uint64_t)(from_s * header.clock_hz),
+                          start + (uint64_t)(to_s * header.clock_hz), counts) != 0) {
+        fprintf(stderr, "%s: corrupt trace\n", trace_path);
+        return 1;
+    }
+    for (i = 0; i < 32; ++i) {
+        if (pin == i || (pin < 0 && (header.mask & (1u << i)))) {
+            printf("pin %2d: %llu\n", i, (unsigned long long)counts[i]);
+        }
+    }
+
+    trace_file_unmap(&idx);
+    trace_file_unmap(&trace);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 3 && argc <= 4 && strcmp(argv[1], "build") == 0) {
+        uint32_t blocks_per_entry = argc == 4 ? (uint32_t)atoi(argv[3]) : TRACE_INDEX_DEFAULT_BLOCKS_PER_ENTRY;
+        if (blocks_per_entry == 0) {
+            usage(argv[0]);
+            return 2;
+        }
+        return build(argv[2], blocks_per_entry);
+    }
+    if (argc >= 5 && argc <= 6 && strcmp(argv[1], "count") == 0) {
+        int pin = argc == 6 ? atoi(argv[5]) : -1;
+        if (pin > 31) {
+            usage(argv[0]);
+            return 2;
+        }
+        return count(argv[2], atof(argv[3]), atof(argv[4]), pin);
+    }
+    usage(argv[0]);
+    return 2;
+}
@@ -0,0 +1,251 @@
+// Replays a recorded GPIO trace through the event monitor on the host.
+//
+//   trace_replay [-s speed] [-m mask] [-w window_ms] [-v] <trace>
+//
+// The trace is memory-mapped and decoded in place; records are fed to the
+// monitor through event_monitor_process_batch() and report windows are closed
+// on trace time. A speed of 0 (the default) replays as fast as possible,
+// 1 in real time, 10 ten times faster than real time, and so on.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "event_monitor.h"
+#include "gpio_hal.h"
+#include "gpio_trace_reader.h"
+#include "rtos_api.h"
+#include "trace_file.h"
+
+#define REPLAY_BATCH_SIZE 256
+
+static gpio_mask_t replay_initial_state = 0;
+static uint32_t replay_timestamp = 0;
+static uint64_t windows_reported = 0;
+static uint64_t total_events = 0;
+static int verbose = 0;
+
+// The monitor runs against a replayed HAL: the initial state comes from the
+// first block, and the timestamp follows trace time as records and window
+// boundaries are fed
+gpio_mask_t gpio_read_input(void) {
+    return replay_initial_state;
+}
+
+void gpio_register_callback(void (*callback)(gpio_mask_t new_state)) {
+    (void)callback;
+}
+
+uint32_t gpio_read_timestamp(void) {
+    return replay_timestamp;
+}
+
+void gpio_set_interrupt_mask(gpio_mask_t mask) {
+    (void)mask;
+}
+
+// Single-threaded replay: no locking, and report windows are driven below
+void rtos_mutex_lock(void) {}
+void rtos_mutex_unlock(void) {}
+void rtos_task_delay_ms(uint32_t ms) { (void)ms; }
+void rtos_task_create(rtos_task_t* task, void (*task_fn)(void*), void* arg) {
+    (void)task; (void)task_fn; (void)arg;
+}
+
+void report_event_count(uint32_t count) {
+    if (verbose) {
+        printf("window %llu: %u events\n", (unsigned long long)windows_reported, count);
+    }
+    ++windows_reported;
+    total_events += count;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// Feeds a batch with the clock at its last record
+static void feed_batch(const gpio_mask_t* states, const uint32_t* timestamps, uint32_t count) {
+    replay_timestamp = timestamps[count - 1];
+    event_monitor_process_batch(states, timestamps, count);
+}
+
+// Sleeps until the wall clock catches up with trace time scaled by speed
+static void pace(double trace_seconds, double speed, double wall_start) {
+    double ahead = trace_seconds / speed - (now_seconds() - wall_start);
+    struct timespec ts;
+
+    if (ahead > 0.001) {
+        ts.tv_sec = (time_t)ahead;
+        ts.tv_nsec = (long)((ahead - (double)ts.tv_sec) * 1e9);
+        nanosleep(&ts, NULL);
+    }
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr, "usage: %s [-s speed] [-m mask] [-w window_ms] [-v] <trace>\n", prog);
+}
+
+int main(int argc, char** argv) {
+    gpio_trace_header_t header;
+    gpio_trace_block_t block;
+    gpio_trace_cursor_t cursor;
+    gpio_trace_record_t record;
+    gpio_mask_t states[REPLAY_BATCH_SIZE];
+    uint32_t timestamps[REPLAY_BATCH_SIZE];
+    uint32_t batched = 0;
+    trace_file_t file;
+    const uint8_t* data;
+    size_t offset;
+    size_t len;
+    uint64_t records = 0;
+    uint64_t dropped = 0;
+    uint64_t start_time = 0;
+    uint64_t last_time = 0;
+    uint64_t window_ticks;
+    uint64_t window_end;
+    gpio_mask_t last_state = 0;
+    double speed = 0.0;
+    double window_ms = 1000.0;
+    double wall_start;
+    double wall_time;
+    double trace_time;
+    unsigned long mask = 0;
+    int have_mask = 0;
+    int started = 0;
+    int synthetic;
+    int result;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "s:m:w:v")) != -1) {
+        switch (opt) {
+        case 's': speed = atof(optarg); break;
+        case 'm': mask = strtoul(optarg, NULL, 0); have_mask = 1; break;
+        case 'w': window_ms = atof(optarg); break;
+        case 'v': verbose = 1; break;
+        default: usage(argv[0]); return 2;
+        }
+    }
+    if (optind != argc - 1 || speed < 0.0 || window_ms <= 0.0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    if (trace_file_map(&file, argv[optind]) != 0) {
+        perror(argv[optind]);
+        return 1;
+    }
+    // Read-ahead friendly: the trace is decoded front to back exactly once
+    trace_file_advise_sequential(&file);
+    data = file.data;
+    len = file.len;
+
+    if (gpio_trace_read_header(data, len, &header, &offset) != 0 || header.clock_hz == 0) {
+        fprintf(stderr, "%s: not a GPIO trace\n", argv[optind]);
+        return 1;
+    }
+    window_ticks = (uint64_t)((double)header.clock_hz * window_ms / 1000.0);
+    if (window_ticks == 0) {
+        window_ticks = 1;
+    }
+
+    wall_start = now_seconds();
+    window_end = 0;
+
+    while ((result = gpio_trace_read_block(data, len, &offset, &block)) == 1) {
+        if (!started) {
+            // Initialize from the first block, exactly as the firmware saw the port
+            replay_initial_state = block.base_state;
+            replay_timestamp = (uint32_t)block.base_timestamp;
+            event_monitor_init(have_mask ? (uint32_t)mask : header.mask);
+            start_time = block.base_timestamp;
+            last_time = start_time;
+            last_state = block.base_state;
+            window_end = start_time + window_ticks;
+            started = 1;
+        }
+        dropped += block.dropped;
+
+        gpio_trace_cursor_init(&cursor, &block);
+        // A block that does not start from the last decoded state follows lost
+        // records; feed its base state so the gap's edges are seen once
+        if (block.base_state != last_state) {
+            record.timestamp = block.base_timestamp;
+            record.state = block.base_state;
+            synthetic = 1;
+            result = 1;
+        } else {
+            synthetic = 0;
+            result = gpio_trace_cursor_next(&cursor, &record);
+        }
+
+        while (result == 1) {
+            // Close every report window that ends before this record
+            while (record.timestamp >= window_end) {
+                if (batched) {
+                    feed_batch(states, timestamps, batched);
+                    batched = 0;
+                }
+                if (speed > 0.0) {
+                    pace((double)(window_end - start_time) / header.clock_hz, speed, wall_start);
+                }
+                // The window closes at its boundary in trace time
+                replay_timestamp = (uint32_t)window_end;
+                event_monitor_report_window();
+                window_end += window_ticks;
+            }
+
+            states[batched] = record.state;
+            timestamps[batched] = (uint32_t)record.timestamp;
+            if (++batched == REPLAY_BATCH_SIZE) {
+                feed_batch(states, timestamps, batched);
+                batched = 0;
+            }
+            last_state = record.state;
+            last_time = record.timestamp;
+            // The base state fed after a gap is not a recorded record
+            if (!synthetic) {
+                ++records;
+            }
+            synthetic = 0;
+
+            result = gpio_trace_cursor_next(&cursor, &record);
+        }
+        if (result < 0) {
+            break;
+        }
+    }
+    if (result < 0) {
+        fprintf(stderr, "%s: corrupt trace at offset %lu\n", argv[optind], (unsigned long)offset);
+    }
+
+    if (batched) {
+        feed_batch(states, timestamps, batched);
+    }
+    if (started) {
+        // Report the final, partial window, ending at the last record
+        replay_timestamp = (uint32_t)last_time;
+        event_monitor_report_window();
+    }
+
+    wall_time = now_seconds() - wall_start;
+    trace_time = (double)(last_time - start_time) / header.clock_hz;
+    trace_file_unmap(&file);
+
+    printf("records:      %llu (%llu dropped while recording)\n",
+           (unsigned long long)records, (unsigned long long)dropped);
+    printf("events:       %llu in %llu windows\n",
+           (unsigned long long)total_events, (unsigned long long)windows_reported);
+    printf("trace time:   %.3f s\n", trace_time);
+    printf("wall time:    %.3f s\n", wall_time);
+    if (wall_time > 0.0) {
+        printf("speed:        %.1fx real time, %.2f M records/s, %.1f MB/s\n",
+               trace_time / wall_time, (double)records / wall_time / 1e6,
+               (double)len / wall_time / 1e6);
+    }
+    return result < 0 ? 1 : 0;
+}
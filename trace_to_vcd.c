@@ -0,0 +1,105 @@
+// Converts a recorded GPIO trace to a Value Change Dump for waveform viewers.
+//
+//   trace_to_vcd [-m mask] [-o output.vcd] <trace>
+//
+// One signal per traced pin (or per pin in mask). The trace is streamed from
+// a memory mapping and the VCD through a fixed buffer, so memory use stays
+// the same whatever the trace size. Writes to stdout without -o.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "gpio_trace_reader.h"
+#include "trace_file.h"
+#include "vcd_writer.h"
+
+static vcd_writer_t writer;
+
+static void file_sink(const uint8_t* data, uint32_t len, void* ctx) {
+    fwrite(data, 1, len, (FILE*)ctx);
+}
+
+int main(int argc, char** argv) {
+    gpio_trace_header_t header;
+    gpio_trace_block_t block;
+    gpio_trace_cursor_t cursor;
+    gpio_trace_record_t record;
+    trace_file_t file;
+    const char* out_path = NULL;
+    FILE* out = stdout;
+    size_t offset;
+    unsigned long mask = 0;
+    int have_mask = 0;
+    int started = 0;
+    int result;
+    int opt;
+    char comment[64];
+
+    while ((opt = getopt(argc, argv, "m:o:")) != -1) {
+        switch (opt) {
+        case 'm': mask = strtoul(optarg, NULL, 0); have_mask = 1; break;
+        case 'o': out_path = optarg; break;
+        default:
+            fprintf(stderr, "usage: %s [-m mask] [-o output.vcd] <trace>\n", argv[0]);
+            return 2;
+        }
+    }
+    if (optind != argc - 1) {
+        fprintf(stderr, "usage: %s [-m mask] [-o output.vcd] <trace>\n", argv[0]);
+        return 2;
+    }
+
+    if (trace_file_map(&file, argv[optind]) != 0) {
+        perror(argv[optind]);
+        return 1;
+    }
+    trace_file_advise_sequential(&file);
+    if (gpio_trace_read_header(file.data, file.len, &header, &offset) != 0) {
+        fprintf(stderr, "%s: not a GPIO trace\n", argv[optind]);
+        return 1;
+    }
+    if (!have_mask) {
+        mask = header.mask;
+    }
+    if (out_path && (out = fopen(out_path, "wb")) == NULL) {
+        perror(out_path);
+        return 1;
+    }
+
+    while ((result = gpio_trace_read_block(file.data, file.len, &offset, &block)) == 1) {
+        if (!started) {
+            vcd_writer_begin(&writer, (gpio_mask_t)mask, header.clock_hz, NULL,
+                             block.base_timestamp, block.base_state, file_sink, out);
+            started = 1;
+        }
+        if (block.dropped) {
+            snprintf(comment, sizeof(comment), "%lu records dropped while recording",
+                     (unsigned long)block.dropped);
+            vcd_writer_comment(&writer, comment);
+        }
+        // A block restarts from the exact state after any lost records
+        vcd_writer_change(&writer, block.base_timestamp, block.base_state);
+
+        gpio_trace_cursor_init(&cursor, &block);
+        while ((result = gpio_trace_cursor_next(&cursor, &record)) == 1) {
+            vcd_writer_change(&writer, record.timestamp, record.state);
+        }
+        if (result < 0) {
+            break;
+        }
+    }
+    if (started) {
+        vcd_writer_end(&writer);
+    }
+    if (result < 0) {
+        fprintf(stderr, "%s: corrupt trace\n", argv[optind]);
+    }
+    if (out != stdout && fclose(out) != 0) {
+        perror(out_path);
+        result = -1;
+    }
+    trace_file_unmap(&file);
+    return result < 0 ? 1 : 0;
+}
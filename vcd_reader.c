@@ -0,0 +1,389 @@
+#include <string.h>
+#include "vcd_reader.h"
+
+// Header sections the parser cares about; everything else is skipped to $end
+enum {
+    SECTION_NONE = 0,
+    SECTION_SKIP,
+    SECTION_VAR,
+    SECTION_SCOPE,
+    SECTION_TIMESCALE,
+    SECTION_ENDDEFINITIONS,
+    SECTION_VECTOR_ID,     // Body: identifier after a 'b' value
+    SECTION_REAL_ID        // Body: identifier after an 'r' value (ignored)
+};
+
+static int token_is(const char* tok, size_t len, const char* word) {
+    return strlen(word) == len && memcmp(tok, word, len) == 0;
+}
+
+static void copy_token(char* dst, size_t size, const char* tok, size_t len) {
+    if (len >= size) {
+        len = size - 1;
+    }
+    memcpy(dst, tok, len);
+    dst[len] = '\0';
+}
+
+void vcd_reader_init(vcd_reader_t* reader, vcd_snapshot_fn snapshot, void* ctx) {
+    memset(reader, 0, sizeof(*reader));
+    reader->snapshot = snapshot;
+    reader->ctx = ctx;
+    memset(reader->short_ids, -1, sizeof(reader->short_ids));
+    // VCD defaults to 1 ns when the file has no $timescale
+    reader->timescale_fs = 1000000;
+}
+
+int vcd_reader_map(vcd_reader_t* reader, const char* name, unsigned bit) {
+    vcd_mapping_t* mapping;
+
+    if (reader->mapping_count == VCD_READER_MAX_SIGNALS || bit >= 32) {
+        return -1;
+    }
+    mapping = &reader->mappings[reader->mapping_count++];
+    copy_token(mapping->name, sizeof(mapping->name), name, strlen(name));
+    mapping->bit = (uint8_t)bit;
+    return 0;
+}
+
+static int find_bit(const vcd_reader_t* reader, int* bit) {
+    char path[2 * VCD_READER_MAX_NAME];
+    unsigned i;
+
+    if (reader->mapping_count == 0) {
+        // Auto-mapping: 1-bit signals in declaration order
+        if (reader->field_size != 1 || reader->signal_count >= 32) {
+            return 0;
+        }
+        *bit = (int)reader->signal_count;
+        return 1;
+    }
+    path[0] = '\0';
+    if (reader->scope[0]) {
+        strcpy(path, reader->scope);
+        strcat(path, ".");
+    }
+    strcat(path, reader->field_ref);
+    for (i = 0; i < reader->mapping_count; ++i) {
+        if (strcmp(reader->mappings[i].name, reader->field_ref) == 0 ||
+            strcmp(reader->mappings[i].name, path) == 0) {
+            *bit = reader->mappings[i].bit;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void end_var(vcd_reader_t* reader) {
+    vcd_signal_t* signal;
+    size_t id_len = strlen(reader->field_id);
+    unsigned width;
+    int bit;
+
+    if (reader->signal_count == VCD_READER_MAX_SIGNALS || !find_bit(reader, &bit)) {
+        return;
+    }
+    width = reader->field_size;
+    if (width == 0 || bit + width > 32) {
+        width = 32 - (unsigned)bit;
+    }
+    signal = &reader->signals[reader->signal_count];
+    memcpy(signal->id, reader->field_id, id_len + 1);
+    signal->id_len = (uint8_t)id_len;
+    signal->bit = (uint8_t)bit;
+    signal->width = (uint8_t)width;
+    if (id_len == 1 && reader->field_id[0] >= '!' && reader->field_id[0] <= '~') {
+        reader->short_ids[reader->field_id[0] - '!'] = (int8_t)reader->signal_count;
+    }
+    reader->mapped_mask |= (width == 32 ? ~(gpio_mask_t)0 : (((gpio_mask_t)1 << width) - 1)) << bit;
+    ++reader->signal_count;
+}
+
+// Parses "<1|10|100> <s|ms|us|ns|ps|fs>", with or without the space
+static void end_timescale(vcd_reader_t* reader) {
+    static const char* const units[] = { "fs", "ps", "ns", "us", "ms", "s" };
+    const char* p = reader->timescale;
+    uint64_t multiplier = 0;
+    uint64_t scale = 1;
+    unsigned i;
+
+    while (*p >= '0' && *p <= '9') {
+        multiplier = multiplier * 10 + (uint64_t)(*p++ - '0');
+    }
+    for (i = 0; i < 6; ++i) {
+        if (strcmp(p, units[i]) == 0) {
+            reader->timescale_fs = (multiplier ? multiplier : 1) * scale;
+            return;
+        }
+        scale *= 1000;
+    }
+    reader->error = 1;
+}
+
+static const vcd_signal_t* find_signal(const vcd_reader_t* reader, const char* id, size_t len) {
+    unsigned i;
+
+    if (len == 1) {
+        int index = (id[0] >= '!' && id[0] <= '~') ? reader->short_ids[id[0] - '!'] : -1;
+        return index < 0 ? NULL : &reader->signals[index];
+    }
+    for (i = 0; i < reader->signal_count; ++i) {
+        if (reader->signals[i].id_len == len && memcmp(reader->signals[i].id, id, len) == 0) {
+            return &reader->signals[i];
+        }
+    }
+    return NULL;
+}
+
+static void set_bits(vcd_reader_t* reader, const vcd_signal_t* signal, gpio_mask_t value) {
+    gpio_mask_t field = (signal->width == 32 ? ~(gpio_mask_t)0 : (((gpio_mask_t)1 << signal->width) - 1)) << signal->bit;
+    gpio_mask_t state = (reader->state & ~field) | ((value << signal->bit) & field);
+
+    if (state != reader->state) {
+        reader->state = state;
+        reader->dirty = 1;
+    }
+}
+
+// Delivers the snapshot of the timestamp that just ended
+static void end_timestamp(vcd_reader_t* reader) {
+    if ((reader->have_time || reader->dirty) && (!reader->emitted || reader->state != reader->emitted_state)) {
+        reader->snapshot(reader->ctx, reader->time, reader->state);
+        reader->emitted_state = reader->state;
+        reader->emitted = 1;
+    }
+    reader->dirty = 0;
+}
+
+static void body_token(vcd_reader_t* reader, const char* tok, size_t len) {
+    const vcd_signal_t* signal;
+    gpio_mask_t value = 0;
+    uint64_t time = 0;
+    size_t i;
+
+    if (reader->section == SECTION_VECTOR_ID || reader->section == SECTION_REAL_ID) {
+        if (reader->section == SECTION_VECTOR_ID && (signal = find_signal(reader, tok, len)) != NULL) {
+            // x and z read as 0, like the scalar case
+            for (i = 0; reader->vector[i]; ++i) {
+                value = (value << 1) | (reader->vector[i] == '1');
+            }
+            set_bits(reader, signal, value);
+        }
+        reader->section = SECTION_NONE;
+        return;
+    }
+
+    switch (tok[0]) {
+    case '#':
+        for (i = 1; i < len; ++i) {
+            if (tok[i] < '0' || tok[i] > '9') {
+                reader->error = 1;
+                return;
+            }
+            time = time * 10 + (uint64_t)(tok[i] - '0');
+        }
+        end_timestamp(reader);
+        reader->time = time;
+        reader->have_time = 1;
+        break;
+    case '0': case '1': case 'x': case 'X': case 'z': case 'Z':
+        if (len > 1 && (signal = find_signal(reader, tok + 1, len - 1)) != NULL) {
+            set_bits(reader, signal, tok[0] == '1');
+        }
+        break;
+    case 'b': case 'B':
+        // Keep only the low 32 bits of the value
+        if (len > 33) {
+            tok += len - 33;
+            len = 33;
+        }
+        memcpy(reader->vector, tok + 1, len - 1);
+        reader->vector[len - 1] = '\0';
+        reader->section = SECTION_VECTOR_ID;
+        break;
+    case 'r': case 'R':
+        reader->section = SECTION_REAL_ID;
+        break;
+    case '$':
+        // $dumpvars, $dumpall, $dumpon, $dumpoff and their $end carry
+        // ordinary value changes; comments are skipped
+        if (token_is(tok, len, "$comment")) {
+            reader->section = SECTION_SKIP;
+        }
+        break;
+    default:
+        reader->error = 1;
+        break;
+    }
+}
+
+static void header_token(vcd_reader_t* reader, const char* tok, size_t len) {
+    if (token_is(tok, len, "$end")) {
+        if (reader->section == SECTION_VAR) {
+            end_var(reader);
+        } else if (reader->section == SECTION_TIMESCALE) {
+            end_timescale(reader);
+        } else if (reader->section == SECTION_ENDDEFINITIONS) {
+            reader->header_done = 1;
+        }
+        reader->section = SECTION_NONE;
+        return;
+    }
+
+    switch (reader->section) {
+    case SECTION_VAR:
+        // $var <type> <size> <id> <reference> [<bit select>] $end
+        if (reader->field == 1) {
+            reader->field_size = 0;
+            while (len--) {
+                reader->field_size = reader->field_size * 10 + (unsigned)(*tok++ - '0');
+            }
+        } else if (reader->field == 2) {
+            copy_token(reader->field_id, sizeof(reader->field_id), tok, len);
+        } else if (reader->field == 3) {
+            copy_token(reader->field_ref, sizeof(reader->field_ref), tok, len);
+        }
+        ++reader->field;
+        return;
+    case SECTION_SCOPE:
+        // $scope <type> <name> $end
+        if (reader->field++ == 1) {
+            size_t used = strlen(reader->scope);
+            if (used && used + 1 < sizeof(reader->scope)) {
+                reader->scope[used++] = '.';
+            }
+            copy_token(reader->scope + used, sizeof(reader->scope) - used, tok, len);
+        }
+        return;
+    case SECTION_TIMESCALE: {
+        size_t used = strlen(reader->timescale);
+        copy_token(reader->timescale + used, sizeof(reader->timescale) - used, tok, len);
+        return;
+    }
+    case SECTION_SKIP:
+    case SECTION_ENDDEFINITIONS:
+        return;
+    default:
+        break;
+    }
+
+    reader->field = 0;
+    if (token_is(tok, len, "$var")) {
+        reader->section = SECTION_VAR;
+        reader->field_id[0] = '\0';
+        reader->field_ref[0] = '\0';
+    } else if (token_is(tok, len, "$scope")) {
+        reader->section = SECTION_SCOPE;
+    } else if (token_is(tok, len, "$upscope")) {
+        char* dot = strrchr(reader->scope, '.');
+        *(dot ? dot : reader->scope) = '\0';
+        reader->section = SECTION_SKIP;
+    } else if (token_is(tok, len, "$timescale")) {
+        reader->section = SECTION_TIMESCALE;
+        reader->timescale[0] = '\0';
+    } else if (token_is(tok, len, "$enddefinitions")) {
+        reader->section = SECTION_ENDDEFINITIONS;
+    } else if (tok[0] == '$') {
+        reader->section = SECTION_SKIP;
+    } else {
+        reader->error = 1;
+    }
+}
+
+static void process_token(vcd_reader_t* reader, const char* tok, size_t len) {
+    if (!reader->header_done) {
+        header_token(reader, tok, len);
+    } else if (reader->section == SECTION_SKIP) {
+        if (token_is(tok, len, "$end")) {
+            reader->section = SECTION_NONE;
+        }
+    } else {
+        body_token(reader, tok, len);
+    }
+}
+
+// Carries part of a token over to the next chunk. An overlong token keeps
+// its head, except a 'b' value, which keeps the tail holding its low bits.
+static void carry_token(vcd_reader_t* reader, const char* part, size_t len) {
+    size_t size = sizeof(reader->pending);
+    char first = reader->pending_len ? reader->pending[0] : part[0];
+    size_t keep;
+
+    if (reader->pending_len + len <= size) {
+        memcpy(reader->pending + reader->pending_len, part, len);
+        reader->pending_len += len;
+    } else if (first != 'b' && first != 'B') {
+        memcpy(reader->pending + reader->pending_len, part, size - reader->pending_len);
+        reader->pending_len = size;
+    } else if (len >= size - 1) {
+        reader->pending[0] = first;
+        memcpy(reader->pending + 1, part + len - (size - 1), size - 1);
+        reader->pending_len = size;
+    } else {
+        // Slide the newest digits already held down behind the 'b'
+        keep = size - 1 - len;
+        memmove(reader->pending + 1, reader->pending + reader->pending_len - keep, keep);
+        memcpy(reader->pending + 1 + keep, part, len);
+        reader->pending_len = size;
+    }
+}
+
+static int is_space(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+int vcd_reader_feed(vcd_reader_t* reader, const char* data, size_t len) {
+    const char* p = data;
+    const char* end = data + len;
+    const char* start;
+
+    while (p < end && !reader->error) {
+        if (reader->in_token) {
+            // Finish a token that began in an earlier chunk
+            start = p;
+            while (p < end && !is_space(*p)) {
+                ++p;
+            }
+            if (p > start) {
+                carry_token(reader, start, (size_t)(p - start));
+            }
+            if (p == end) {
+                break;
+            }
+            reader->in_token = 0;
+            process_token(reader, reader->pending, reader->pending_len);
+            continue;
+        }
+
+        while (p < end && is_space(*p)) {
+            ++p;
+        }
+        start = p;
+        while (p < end && !is_space(*p)) {
+            ++p;
+        }
+        if (p == start) {
+            break;
+        }
+        if (p == end) {
+            // The token may continue in the next chunk
+            reader->pending_len = 0;
+            carry_token(reader, start, (size_t)(p - start));
+            reader->in_token = 1;
+            break;
+        }
+        process_token(reader, start, (size_t)(p - start));
+    }
+    return reader->error ? -1 : 0;
+}
+
+int vcd_reader_finish(vcd_reader_t* reader) {
+    if (reader->in_token) {
+        reader->in_token = 0;
+        process_token(reader, reader->pending, reader->pending_len);
+    }
+    if (!reader->error && reader->header_done) {
+        end_timestamp(reader);
+    }
+    return (reader->error || !reader->header_done) ? -1 : 0;
+}
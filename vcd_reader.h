@@ -0,0 +1,88 @@
+#ifndef VCD_READER_H
+#define VCD_READER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "gpio_hal.h"
+
+// Streaming Value Change Dump (IEEE 1364) parser. Input is pushed in chunks
+// of any size; tokens split across chunks are carried over in a small fixed
+// buffer, so memory use does not depend on the size of the file; of a split
+// 'b' value wider than the buffer, the low bits are kept. Named
+// signals are mapped to bits of a gpio_mask_t and a snapshot of the port
+// state is delivered for every timestamp at which a mapped signal changed.
+
+#define VCD_READER_MAX_SIGNALS 32
+#define VCD_READER_MAX_TOKEN 128
+#define VCD_READER_MAX_ID 16
+#define VCD_READER_MAX_NAME 64
+
+// Receives the port state after all changes at time (in timescale units).
+// The first call carries the initial state.
+typedef void (*vcd_snapshot_fn)(void* ctx, uint64_t time, gpio_mask_t state);
+
+typedef struct {
+    char id[VCD_READER_MAX_ID];
+    uint8_t id_len;
+    uint8_t bit;                 // Bit of the signal's LSB
+    uint8_t width;
+} vcd_signal_t;
+
+typedef struct {
+    char name[VCD_READER_MAX_NAME];
+    uint8_t bit;
+} vcd_mapping_t;
+
+typedef struct {
+    vcd_snapshot_fn snapshot;
+    void* ctx;
+
+    // Requested name to bit mappings; empty maps 1-bit signals in declaration order
+    vcd_mapping_t mappings[VCD_READER_MAX_SIGNALS];
+    unsigned mapping_count;
+
+    // Declared signals that map to port bits
+    vcd_signal_t signals[VCD_READER_MAX_SIGNALS];
+    unsigned signal_count;
+    int8_t short_ids[94];        // Signal index by one-character id, -1 if unmapped
+    gpio_mask_t mapped_mask;
+    uint64_t timescale_fs;       // Femtoseconds per time unit
+
+    // Parser state
+    char scope[VCD_READER_MAX_NAME];  // Dotted path of the open scopes
+    int section;
+    unsigned field;
+    char field_id[VCD_READER_MAX_ID];
+    char field_ref[VCD_READER_MAX_NAME];
+    unsigned field_size;
+    char timescale[16];
+    char vector[33];             // Pending 'b' value, LSB last
+    int header_done;
+    int error;
+
+    // Snapshot state
+    gpio_mask_t state;
+    gpio_mask_t emitted_state;
+    uint64_t time;
+    int have_time;
+    int dirty;
+    int emitted;
+
+    char pending[VCD_READER_MAX_TOKEN];
+    size_t pending_len;
+    int in_token;
+} vcd_reader_t;
+
+void vcd_reader_init(vcd_reader_t* reader, vcd_snapshot_fn snapshot, void* ctx);
+
+// Maps the signal named name (its reference, or scope.reference) to bit.
+// Must be called before the header is fed. Returns 0, or -1 if the table is full.
+int vcd_reader_map(vcd_reader_t* reader, const char* name, unsigned bit);
+
+// Parses the next chunk. Returns 0 on success, -1 on a malformed file.
+int vcd_reader_feed(vcd_reader_t* reader, const char* data, size_t len);
+
+// Parses any final token and delivers the last snapshot
+int vcd_reader_finish(vcd_reader_t* reader);
+
+#endif // VCD_READER_H
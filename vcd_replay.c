@@ -0,0 +1,215 @@
+// Replays a logic-analyzer VCD capture through the event monitor on the host.
+//
+//   vcd_replay [-p name=bit]... [-m mask] [-w window_ms] [-c clock_hz] [-v] <capture.vcd>
+//
+// Each -p maps a VCD signal (by reference or scope.reference) to a port bit;
+// without -p the 1-bit signals are mapped to bits 0, 1, 2... in declaration
+// order. The file is read in fixed-size chunks and parsed as a stream, and
+// the resulting port snapshots are fed to the monitor through
+// event_monitor_process_batch(). Report windows are closed on capture time.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "event_monitor.h"
+#include "gpio_hal.h"
+#include "rtos_api.h"
+#include "vcd_reader.h"
+
+#define READ_CHUNK_SIZE (1024 * 1024)
+#define REPLAY_BATCH_SIZE 256
+
+static char chunk[READ_CHUNK_SIZE];
+static vcd_reader_t reader;
+
+static gpio_mask_t states[REPLAY_BATCH_SIZE];
+static uint32_t timestamps[REPLAY_BATCH_SIZE];
+static uint32_t batched = 0;
+
+static gpio_mask_t replay_initial_state = 0;
+static uint32_t monitor_mask = 0;
+static int have_mask = 0;
+static int started = 0;
+static double window_ms = 1000.0;
+static double clock_hz = 1000000.0;
+static double ticks_per_unit = 0.0;
+static uint64_t window_units = 0;
+static uint64_t window_end = 0;
+static uint64_t first_time = 0;
+static uint64_t last_time = 0;
+static uint64_t snapshots = 0;
+static uint64_t windows_reported = 0;
+static uint64_t total_events = 0;
+static int verbose = 0;
+
+// The monitor runs against a replayed HAL
+gpio_mask_t gpio_read_input(void) {
+    return replay_initial_state;
+}
+
+void gpio_register_callback(void (*callback)(gpio_mask_t new_state)) {
+    (void)callback;
+}
+
+uint32_t gpio_read_timestamp(void) {
+    return batched ? timestamps[batched - 1] : 0;
+}
+
+void gpio_set_interrupt_mask(gpio_mask_t mask) {
+    (void)mask;
+}
+
+// Single-threaded replay: no locking, and report windows are driven below
+void rtos_mutex_lock(void) {}
+void rtos_mutex_unlock(void) {}
+void rtos_task_delay_ms(uint32_t ms) { (void)ms; }
+void rtos_task_create(rtos_task_t* task, void (*task_fn)(void*), void* arg) {
+    (void)task; (void)task_fn; (void)arg;
+}
+
+void report_event_count(uint32_t count) {
+    if (verbose) {
+        printf("window %llu: %u events\n", (unsigned long long)windows_reported, count);
+    }
+    ++windows_reported;
+    total_events += count;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void flush_batch(void) {
+    if (batched) {
+        event_monitor_process_batch(states, timestamps, batched);
+        batched = 0;
+    }
+}
+
+static void on_snapshot(void* ctx, uint64_t time, gpio_mask_t state) {
+    (void)ctx;
+
+    if (!started) {
+        // Snapshots only come after the header, so the timescale is known
+        ticks_per_unit = (double)reader.timescale_fs * clock_hz / 1e15;
+        window_units = (uint64_t)(window_ms * 1e12 / (double)reader.timescale_fs);
+        if (window_units == 0) {
+            window_units = 1;
+        }
+        // The first snapshot is the port state the monitor starts from
+        replay_initial_state = state;
+        event_monitor_init(have_mask ? monitor_mask : reader.mapped_mask);
+        first_time = time;
+        window_end = time + window_units;
+        started = 1;
+        return;
+    }
+
+    while (time >= window_end) {
+        flush_batch();
+        event_monitor_report_window();
+        window_end += window_units;
+    }
+    states[batched] = state;
+    timestamps[batched] = (uint32_t)(uint64_t)((double)time * ticks_per_unit);
+    if (++batched == REPLAY_BATCH_SIZE) {
+        flush_batch();
+    }
+    last_time = time;
+    ++snapshots;
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr, "usage: %s [-p name=bit]... [-m mask] [-w window_ms] [-c clock_hz] [-v] <capture.vcd>\n", prog);
+}
+
+int main(int argc, char** argv) {
+    double wall_start;
+    double wall_time;
+    double capture_time;
+    uint64_t bytes = 0;
+    ssize_t n = 0;
+    char* eq;
+    int status = 0;
+    int fd;
+    int opt;
+
+    vcd_reader_init(&reader, on_snapshot, NULL);
+
+    while ((opt = getopt(argc, argv, "p:m:w:c:v")) != -1) {
+        switch (opt) {
+        case 'p':
+            eq = strrchr(optarg, '=');
+            if (eq == NULL) {
+                usage(argv[0]);
+                return 2;
+            }
+            *eq = '\0';
+            if (vcd_reader_map(&reader, optarg, (unsigned)atoi(eq + 1)) != 0) {
+                fprintf(stderr, "%s: bad mapping %s\n", argv[0], optarg);
+                return 2;
+            }
+            break;
+        case 'm': monitor_mask = (uint32_t)strtoul(optarg, NULL, 0); have_mask = 1; break;
+        case 'w': window_ms = atof(optarg); break;
+        case 'c': clock_hz = atof(optarg); break;
+        case 'v': verbose = 1; break;
+        default: usage(argv[0]); return 2;
+        }
+    }
+    if (optind != argc - 1 || window_ms <= 0.0 || clock_hz <= 0.0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    fd = open(argv[optind], O_RDONLY);
+    if (fd < 0) {
+        perror(argv[optind]);
+        return 1;
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    wall_start = now_seconds();
+    while (status == 0 && (n = read(fd, chunk, sizeof(chunk))) > 0) {
+        bytes += (uint64_t)n;
+        status = vcd_reader_feed(&reader, chunk, (size_t)n);
+    }
+    close(fd);
+    if (n < 0) {
+        perror(argv[optind]);
+        return 1;
+    }
+    if (status != 0 || vcd_reader_finish(&reader) != 0) {
+        fprintf(stderr, "%s: malformed VCD\n", argv[optind]);
+        return 1;
+    }
+    if (!started) {
+        fprintf(stderr, "%s: no changes on mapped signals\n", argv[optind]);
+        return 1;
+    }
+    flush_batch();
+    // Report the final, partial window
+    event_monitor_report_window();
+
+    wall_time = now_seconds() - wall_start;
+    capture_time = (double)(last_time - first_time) * (double)reader.timescale_fs / 1e15;
+
+    printf("signals:      %u mapped (mask 0x%08lx)\n", reader.signal_count, (unsigned long)reader.mapped_mask);
+    printf("snapshots:    %llu\n", (unsigned long long)snapshots);
+    printf("events:       %llu in %llu windows\n",
+           (unsigned long long)total_events, (unsigned long long)windows_reported);
+    printf("capture time: %.6f s\n", capture_time);
+    printf("wall time:    %.3f s\n", wall_time);
+    if (wall_time > 0.0) {
+        printf("speed:        %.1f MB/s, %.2f M snapshots/s\n",
+               (double)bytes / wall_time / 1e6, (double)snapshots / wall_time / 1e6);
+    }
+    return 0;
+}
@@ -0,0 +1,170 @@
+#include <string.h>
+#include "vcd_writer.h"
+
+// Longest single write: a timestamp line or one value change
+#define VCD_MAX_LINE 64
+
+static void flush(vcd_writer_t* writer) {
+    if (writer->len) {
+        writer->sink((const uint8_t*)writer->buffer, writer->len, writer->ctx);
+        writer->len = 0;
+    }
+}
+
+static void put_str(vcd_writer_t* writer, const char* s) {
+    size_t n = strlen(s);
+
+    if (writer->len + n > VCD_WRITER_BUFFER_SIZE) {
+        flush(writer);
+    }
+    if (n > VCD_WRITER_BUFFER_SIZE) {
+        writer->sink((const uint8_t*)s, (uint32_t)n, writer->ctx);
+        return;
+    }
+    memcpy(writer->buffer + writer->len, s, n);
+    writer->len += (uint32_t)n;
+}
+
+static void put_u64(vcd_writer_t* writer, uint64_t v) {
+    char digits[21];
+    int i = (int)sizeof(digits) - 1;
+
+    digits[i] = '\0';
+    do {
+        digits[--i] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+    put_str(writer, digits + i);
+}
+
+// Value change: '0' or '1' followed by the pin's one-character identifier
+static void put_value(vcd_writer_t* writer, unsigned pin, int value) {
+    if (writer->len + 3 > VCD_WRITER_BUFFER_SIZE) {
+        flush(writer);
+    }
+    writer->buffer[writer->len++] = value ? '1' : '0';
+    writer->buffer[writer->len++] = (char)('!' + pin);
+    writer->buffer[writer->len++] = '\n';
+}
+
+static uint64_t to_units(const vcd_writer_t* writer, uint64_t time) {
+    uint64_t ticks = time - writer->start_time;
+
+    if (writer->units_per_tick) {
+        return ticks * writer->units_per_tick;
+    }
+    // Split to keep the intermediate product within 64 bits
+    return (ticks / writer->clock_hz) * writer->units_per_second +
+           (ticks % writer->clock_hz) * writer->units_per_second / writer->clock_hz;
+}
+
+static void put_time(vcd_writer_t* writer, uint64_t time) {
+    put_str(writer, "#");
+    put_u64(writer, to_units(writer, time));
+    put_str(writer, "\n");
+    writer->last_time = time;
+}
+
+// Picks the coarsest power-of-ten timescale, down to 1 ns, that represents a
+// tick exactly; other clock rates are rounded to nanoseconds
+static void put_timescale(vcd_writer_t* writer) {
+    static const char* const units[] = { "s", "ms", "us", "ns" };
+    static const char* const mantissas[] = { "1 ", "10 ", "100 " };
+    uint64_t per_second = 1;
+    int k;
+
+    writer->units_per_tick = 0;
+    writer->units_per_second = 1000000000ull;
+    for (k = 0; k <= 9; ++k) {
+        if (per_second % writer->clock_hz == 0) {
+            writer->units_per_tick = per_second / writer->clock_hz;
+            break;
+        }
+        per_second *= 10;
+    }
+    if (k > 9) {
+        k = 9;
+    }
+
+    put_str(writer, "$timescale ");
+    put_str(writer, mantissas[((k + 2) / 3) * 3 - k]);
+    put_str(writer, units[(k + 2) / 3]);
+    put_str(writer, " $end\n");
+}
+
+void vcd_writer_begin(vcd_writer_t* writer, gpio_mask_t mask, uint32_t clock_hz,
+                      const char* const* names, uint64_t start_time, gpio_mask_t initial_state,
+                      gpio_trace_sink_t sink, void* ctx) {
+    char name[8];
+    unsigned pin;
+
+    writer->sink = sink;
+    writer->ctx = ctx;
+    writer->mask = mask;
+    writer->state = initial_state & mask;
+    writer->start_time = start_time;
+    writer->clock_hz = clock_hz ? clock_hz : 1;
+    writer->len = 0;
+
+    put_str(writer, "$version event_monitor GPIO export $end\n");
+    put_timescale(writer);
+    put_str(writer, "$scope module gpio $end\n");
+    for (pin = 0; pin < 32; ++pin) {
+        if (!(mask & (1u << pin))) {
+            continue;
+        }
+        name[0] = (char)('!' + pin);
+        name[1] = '\0';
+        put_str(writer, "$var wire 1 ");
+        put_str(writer, name);
+        put_str(writer, " ");
+        if (names && names[pin]) {
+            put_str(writer, names[pin]);
+        } else {
+            put_str(writer, "pin");
+            put_u64(writer, pin);
+        }
+        put_str(writer, " $end\n");
+    }
+    put_str(writer, "$upscope $end\n$enddefinitions $end\n");
+
+    put_time(writer, start_time);
+    put_str(writer, "$dumpvars\n");
+    for (pin = 0; pin < 32; ++pin) {
+        if (mask & (1u << pin)) {
+            put_value(writer, pin, (int)((writer->state >> pin) & 1u));
+        }
+    }
+    put_str(writer, "$end\n");
+}
+
+void vcd_writer_change(vcd_writer_t* writer, uint64_t time, gpio_mask_t state) {
+    gpio_mask_t changed = (state ^ writer->state) & writer->mask;
+    unsigned pin = 0;
+
+    if (!changed) {
+        return;
+    }
+    // Changes sharing a timestamp go under one time line
+    if (time != writer->last_time) {
+        put_time(writer, time);
+    }
+    writer->state ^= changed;
+    while (changed) {
+        if (changed & 1u) {
+            put_value(writer, pin, (int)((state >> pin) & 1u));
+        }
+        changed >>= 1;
+        ++pin;
+    }
+}
+
+void vcd_writer_comment(vcd_writer_t* writer, const char* text) {
+    put_str(writer, "$comment ");
+    put_str(writer, text);
+    put_str(writer, " $end\n");
+}
+
+void vcd_writer_end(vcd_writer_t* writer) {
+    flush(writer);
+}
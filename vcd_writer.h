@@ -0,0 +1,45 @@
+#ifndef VCD_WRITER_H
+#define VCD_WRITER_H
+
+#include <stdint.h>
+#include "gpio_hal.h"
+#include "gpio_trace.h"
+
+// Streaming Value Change Dump (IEEE 1364) writer with one 1-bit signal per
+// pin. Output goes through a fixed buffer to the sink, so memory use does not
+// depend on the length of the stream.
+
+#ifndef VCD_WRITER_BUFFER_SIZE
+#define VCD_WRITER_BUFFER_SIZE 4096
+#endif
+
+typedef struct {
+    gpio_trace_sink_t sink;
+    void* ctx;
+    gpio_mask_t mask;            // Pins with a signal
+    gpio_mask_t state;           // Last written values
+    uint64_t start_time;         // Ticks at VCD time 0
+    uint64_t last_time;          // Ticks of the last written timestamp
+    uint32_t clock_hz;
+    uint64_t units_per_tick;     // Exact conversion when non-zero
+    uint64_t units_per_second;   // Otherwise ticks are scaled to ns
+    uint32_t len;
+    char buffer[VCD_WRITER_BUFFER_SIZE];
+} vcd_writer_t;
+
+// Writes the header and the initial values at start_time.
+// names may be NULL to name signals pin0..pin31.
+void vcd_writer_begin(vcd_writer_t* writer, gpio_mask_t mask, uint32_t clock_hz,
+                      const char* const* names, uint64_t start_time, gpio_mask_t initial_state,
+                      gpio_trace_sink_t sink, void* ctx);
+
+// Writes the pins that changed since the last call; time must not go backwards
+void vcd_writer_change(vcd_writer_t* writer, uint64_t time, gpio_mask_t state);
+
+// Writes a $comment section at the current time
+void vcd_writer_comment(vcd_writer_t* writer, const char* text);
+
+// Writes out the buffered output
+void vcd_writer_end(vcd_writer_t* writer);
+
+#endif // VCD_WRITER_H
@@ -0,0 +1,141 @@
+#include <stddef.h>
+#include "window_history.h"
+#include "event_monitor.h"
+#include "pin_bits.h"
+
+typedef struct {
+    uint32_t total;
+    uint16_t pins[WINDOW_HISTORY_PINS];
+} window_entry_t;
+
+static volatile gpio_mask_t recorded_pins = 0;
+static unsigned pin_count = 0;
+
+// Odd while the monitor task is appending a window or init is resetting
+static volatile uint32_t sequence = 0;
+static volatile window_entry_t ring[WINDOW_HISTORY_DEPTH];
+static volatile uint32_t written = 0;
+
+// Appends the window from the monitor's report, which carries its per-pin counts
+static void window_history_report(const event_report_t* report) {
+    uint32_t counts[WINDOW_HISTORY_PINS];
+    window_entry_t entry;
+    volatile window_entry_t* slot;
+    unsigned i;
+
+    pin_bits_gather(counts, report->pin_counts, recorded_pins);
+    event_monitor_release_report(report);
+
+    entry.total = 0;
+    for (i = 0; i < pin_count; ++i) {
+        entry.total += counts[i];
+        entry.pins[i] = counts[i] > 0xFFFFu ? 0xFFFFu : (uint16_t)counts[i];
+    }
+
+    // Only the monitor task writes, so the sequence needs no lock
+    slot = &ring[written % WINDOW_HISTORY_DEPTH];
+    ++sequence;
+    PIN_BITS_BARRIER();
+    slot->total = entry.total;
+    for (i = 0; i < pin_count; ++i) {
+        slot->pins[i] = entry.pins[i];
+    }
+    ++written;
+    PIN_BITS_BARRIER();
+    ++sequence;
+}
+
+uint32_t window_history_count(void) {
+    return written;
+}
+
+// Sorts a few values in place
+static void sort_values(uint32_t* values, unsigned count) {
+    unsigned i;
+    unsigned j;
+
+    for (i = 1; i < count; ++i) {
+        uint32_t value = values[i];
+        for (j = i; j > 0 && values[j - 1] > value; --j) {
+            values[j] = values[j - 1];
+        }
+        values[j] = value;
+    }
+}
+
+int window_history_stats(unsigned pin, unsigned windows, unsigned percentile, window_stats_t* stats) {
+    uint32_t values[WINDOW_HISTORY_DEPTH];
+    gpio_mask_t pins;
+    uint32_t begin;
+    uint32_t end;
+    uint32_t sum = 0;
+    unsigned index = 0;
+    unsigned rank;
+    unsigned n;
+
+    if (percentile > 100 || (pin != WINDOW_HISTORY_ALL && pin >= 32)) {
+        return -1;
+    }
+    if (windows > WINDOW_HISTORY_DEPTH) {
+        windows = WINDOW_HISTORY_DEPTH;
+    }
+
+    // Copy the windows, retrying if the monitor task appended or init reset
+    // the pins meanwhile
+    do {
+        begin = sequence;
+        PIN_BITS_BARRIER();
+        pins = recorded_pins;
+        end = written;
+        n = end < windows ? end : windows;
+        if (pin != WINDOW_HISTORY_ALL) {
+            if (!(pins & (1u << pin))) {
+                n = 0;
+            }
+            index = pin_bits_rank(pins, pin);
+        }
+        for (rank = 0; rank < n; ++rank) {
+            volatile const window_entry_t* entry = &ring[(end - n + rank) % WINDOW_HISTORY_DEPTH];
+            values[rank] = pin == WINDOW_HISTORY_ALL ? entry->total : entry->pins[index];
+        }
+        PIN_BITS_BARRIER();
+    } while ((begin & 1u) || sequence != begin);
+
+    if (n == 0) {
+        return -1;
+    }
+
+    sort_values(values, n);
+    for (rank = 0; rank < n; ++rank) {
+        sum += values[rank];
+    }
+    // Nearest rank: the smallest value with at least percentile% at or below it
+    rank = (percentile * n + 99) / 100;
+
+    stats->windows = n;
+    stats->min = values[0];
+    stats->max = values[n - 1];
+    stats->sum = sum;
+    stats->mean = (sum + n / 2) / n;
+    stats->percentile = values[rank ? rank - 1 : 0];
+    return 0;
+}
+
+int window_history_init(gpio_mask_t pins) {
+    if (pin_bits_count(pins) > WINDOW_HISTORY_PINS) {
+        return -1;
+    }
+
+    event_monitor_remove_report_sink(window_history_report);
+
+    ++sequence;
+    PIN_BITS_BARRIER();
+    recorded_pins = pins;
+    pin_count = pin_bits_count(pins);
+    written = 0;
+    PIN_BITS_BARRIER();
+    ++sequence;
+
+    event_monitor_count_pins(1);
+    return event_monitor_add_report_sink(window_history_report);
+}
@@ -0,0 +1,53 @@
+#ifndef WINDOW_HISTORY_H
+#define WINDOW_HISTORY_H
+
+#include <stdint.h>
+#include "gpio_hal.h"
+
+// Ring of the last WINDOW_HISTORY_DEPTH report windows: the aggregate count
+// and a 16-bit count per recorded pin (saturating), dense by rank in the
+// pin mask. The monitor task appends a window after each
+// report_event_count(), taking the counts from the monitor's report; readers
+// copy under a sequence counter and retry if a window was appended
+// meanwhile, so queries never block the monitor task. Re-initializing
+// bumps the same counter, so a query never pairs new pins with old windows.
+
+// Windows kept
+#ifndef WINDOW_HISTORY_DEPTH
+#define WINDOW_HISTORY_DEPTH 32
+#endif
+
+// Recorded pins at most
+#ifndef WINDOW_HISTORY_PINS
+#define WINDOW_HISTORY_PINS 8
+#endif
+
+// Pass as the pin to query the aggregate count of all recorded pins
+#define WINDOW_HISTORY_ALL 32
+
+// Statistics over the last windows
+typedef struct {
+    uint32_t windows;     // Windows the statistics cover
+    uint32_t min;
+    uint32_t max;
+    uint32_t sum;
+    uint32_t mean;        // sum / windows, rounded to nearest
+    uint32_t percentile;  // Nearest-rank percentile
+} window_stats_t;
+
+// Starts recording windows of rising edges on pins (monitored pins only are
+// seen) and enables the monitor's per-pin counting. Returns 0 on success, -1
+// if pins has more than WINDOW_HISTORY_PINS pins or the report sink table is
+// full.
+int window_history_init(gpio_mask_t pins);
+
+// Returns the number of windows recorded so far; may exceed the depth
+uint32_t window_history_count(void);
+
+// Computes statistics of a recorded pin, or WINDOW_HISTORY_ALL, over the
+// last windows (fewer if fewer are kept), with the given percentile
+// (0-100). Returns 0 on success, -1 if the pin is not recorded, no window
+// has been recorded yet, or the percentile is out of range.
+int window_history_stats(unsigned pin, unsigned windows, unsigned percentile, window_stats_t* stats);
+
+#endif // WINDOW_HISTORY_H